@@ -50,7 +50,12 @@
 #include "xil_printf.h"
 
 P_LOGICAL_SLICE_MAP logicalSliceMapPtr;
+#if (EXTENT_FORWARD_MAP)
+P_EXTENT_MAP extentMapPtr;
+#endif
+P_SECTOR_VALID_MAP sectorValidMapPtr;
 P_VIRTUAL_SLICE_MAP virtualSliceMapPtr;
+P_VALID_SLICE_BITMAP validSliceBitmapPtr;
 P_VIRTUAL_BLOCK_MAP virtualBlockMapPtr;
 P_VIRTUAL_DIE_MAP virtualDieMapPtr;
 P_PHY_BLOCK_MAP phyBlockMapPtr;
@@ -58,6 +63,9 @@ P_BAD_BLOCK_TABLE_INFO_MAP bbtInfoMapPtr;
 
 unsigned char sliceAllocationTargetDie;
 unsigned int mbPerbadBlockSpace;
+#if (REVERSE_MAP_IN_SPARE)
+unsigned int gcCopyReadCnt;
+#endif
 
 
 void InitAddressMap()
@@ -65,11 +73,22 @@ void InitAddressMap()
 	unsigned int blockNo, dieNo;
 
 	logicalSliceMapPtr = (P_LOGICAL_SLICE_MAP ) LOGICAL_SLICE_MAP_ADDR;
+#if (EXTENT_FORWARD_MAP)
+	extentMapPtr = (P_EXTENT_MAP) EXTENT_MAP_ADDR;
+#endif
+	sectorValidMapPtr = (P_SECTOR_VALID_MAP) SECTOR_VALID_MAP_ADDR;
+#if (REVERSE_MAP_IN_SPARE)
+	validSliceBitmapPtr = (P_VALID_SLICE_BITMAP) VALID_SLICE_BITMAP_ADDR;
+#else
 	virtualSliceMapPtr = (P_VIRTUAL_SLICE_MAP) VIRTUAL_SLICE_MAP_ADDR;
+#endif
 	virtualBlockMapPtr = (P_VIRTUAL_BLOCK_MAP) VIRTUAL_BLOCK_MAP_ADDR;
 	virtualDieMapPtr = (P_VIRTUAL_DIE_MAP) VIRTUAL_DIE_MAP_ADDR;
 	phyBlockMapPtr = (P_PHY_BLOCK_MAP) PHY_BLOCK_MAP_ADDR;
 	bbtInfoMapPtr = (P_BAD_BLOCK_TABLE_INFO_MAP) BAD_BLOCK_TABLE_INFO_MAP_ADDR;
+#if (REVERSE_MAP_IN_SPARE)
+	gcCopyReadCnt = 0;
+#endif
 
 	//init phyblockMap
 	for(dieNo=0 ; dieNo<USER_DIES ; dieNo++)
@@ -81,7 +100,9 @@ void InitAddressMap()
 		bbtInfoMapPtr->bbtInfo[dieNo].grownBadUpdate = BBT_INFO_GROWN_BAD_UPDATE_NONE;
 	}
 
-	sliceAllocationTargetDie = FindDieForFreeSliceAllocation();
+#if (EXTENT_FORWARD_MAP)
+	xil_printf("[ forward map: %d KB slice map + %d KB extent map ]\r\n", sizeof(LOGICAL_SLICE_MAP) / 1024, sizeof(EXTENT_MAP) / 1024);
+#endif
 
 	InitSliceMap();
 	InitBlockDieMap();
@@ -90,11 +111,26 @@ void InitAddressMap()
 void InitSliceMap()
 {
 	int sliceAddr;
+#if (EXTENT_FORWARD_MAP)
+	int regionNo;
+#endif
+
 	for(sliceAddr=0; sliceAddr<SLICES_PER_SSD ; sliceAddr++)
 	{
 		logicalSliceMapPtr->logicalSlice[sliceAddr].virtualSliceAddr = VSA_NONE;
-		virtualSliceMapPtr->virtualSlice[sliceAddr].logicalSliceAddr = LSA_NONE;
+		sectorValidMapPtr->logicalSlice[sliceAddr].validSectorMask = SECTOR_MASK_NONE;
+		UpdateVirtualSliceMap(sliceAddr, LSA_NONE);
+	}
+
+#if (EXTENT_FORWARD_MAP)
+	//every region starts as an empty extent
+	for(regionNo=0; regionNo<EXTENT_REGIONS_PER_SSD ; regionNo++)
+	{
+		extentMapPtr->region[regionNo].mode = REGION_MAP_MODE_EXTENT;
+		extentMapPtr->region[regionNo].startSlice = 0;
+		extentMapPtr->region[regionNo].length = 0;
 	}
+#endif
 }
 
 void RemapBadBlock()
@@ -226,17 +262,17 @@ void InitBlockMap()
 		{
 			phyBlockNo = Vblock2PblockOfTbsTranslation(virtualBlockNo);
 			remappedPhyBlock = phyBlockMapPtr->phyBlock[dieNo][phyBlockNo].remappedPhyBlock;
-			virtualBlockMapPtr->block[dieNo][virtualBlockNo].bad = phyBlockMapPtr->phyBlock[dieNo][remappedPhyBlock].bad;
+			virtualBlockMapPtr->bad[dieNo][virtualBlockNo] = phyBlockMapPtr->phyBlock[dieNo][remappedPhyBlock].bad;
 
-			virtualBlockMapPtr->block[dieNo][virtualBlockNo].free = 1;
-			virtualBlockMapPtr->block[dieNo][virtualBlockNo].invalidSliceCnt = 0;
-			virtualBlockMapPtr->block[dieNo][virtualBlockNo].currentPage = 0;
-			virtualBlockMapPtr->block[dieNo][virtualBlockNo].eraseCnt = 0;
+			virtualBlockMapPtr->free[dieNo][virtualBlockNo] = 1;
+			virtualBlockMapPtr->invalidSliceCnt[dieNo][virtualBlockNo] = 0;
+			virtualBlockMapPtr->currentPage[dieNo][virtualBlockNo] = 0;
+			virtualBlockMapPtr->eraseCnt[dieNo][virtualBlockNo] = 0;
 
-			if(virtualBlockMapPtr->block[dieNo][virtualBlockNo].bad)
+			if(virtualBlockMapPtr->bad[dieNo][virtualBlockNo])
 			{
-				virtualBlockMapPtr->block[dieNo][virtualBlockNo].prevBlock = BLOCK_NONE;
-				virtualBlockMapPtr->block[dieNo][virtualBlockNo].nextBlock = BLOCK_NONE;
+				virtualBlockMapPtr->prevBlock[dieNo][virtualBlockNo] = BLOCK_NONE;
+				virtualBlockMapPtr->nextBlock[dieNo][virtualBlockNo] = BLOCK_NONE;
 			}
 			else
 				PutToFbList(dieNo, virtualBlockNo);
@@ -253,6 +289,11 @@ void InitCurrentBlockOfDieMap()
 		virtualDieMapPtr->die[dieNo].currentBlock = GetFromFbList(dieNo, GET_FREE_BLOCK_NORMAL);
 		if(virtualDieMapPtr->die[dieNo].currentBlock == BLOCK_FAIL)
 			assert(!"[WARNING] There is no free block [WARNING]");
+
+		virtualDieMapPtr->die[dieNo].siblingBlock = BLOCK_NONE;
+#if (MULTI_PLANE_OPERATION)
+		AlternateSiblingBlock(dieNo);
+#endif
 	}
 }
 
@@ -572,7 +613,7 @@ void EraseUserBlockSpace()
 
 	for(blockNo=0 ; blockNo<USER_BLOCKS_PER_DIE ; blockNo++)
 		for(dieNo=0 ; dieNo<USER_DIES ; dieNo++)
-			if(!virtualBlockMapPtr->block[dieNo][blockNo].bad)
+			if(!virtualBlockMapPtr->bad[dieNo][blockNo])
 			{
 				reqSlotTag = GetFromFreeReqQ();
 
@@ -624,13 +665,106 @@ void InitBlockDieMap()
 	InitCurrentBlockOfDieMap();
 }
 
+#if (EXTENT_FORWARD_MAP)
+//expand the extent of the region into per-slice entries, the region is translated by logicalSliceMap from now on
+void DemoteExtentRegion(unsigned int regionNo)
+{
+	unsigned int sliceOffset, logicalSliceAddr;
+
+	logicalSliceAddr = regionNo * SLICES_PER_EXTENT_REGION + extentMapPtr->region[regionNo].startSlice;
+	for(sliceOffset=0 ; sliceOffset<extentMapPtr->region[regionNo].length ; sliceOffset++)
+		logicalSliceMapPtr->logicalSlice[logicalSliceAddr + sliceOffset].virtualSliceAddr =
+				extentMapPtr->region[regionNo].laneVsa[sliceOffset % USER_DIES] + (sliceOffset / USER_DIES) * USER_DIES;
+
+	extentMapPtr->region[regionNo].mode = REGION_MAP_MODE_SLICE;
+}
+#endif
+
+unsigned int LookupLogicalSliceMap(unsigned int logicalSliceAddr)
+{
+#if (EXTENT_FORWARD_MAP)
+	unsigned int regionNo, sliceOffset;
+
+	regionNo = logicalSliceAddr / SLICES_PER_EXTENT_REGION;
+	if(extentMapPtr->region[regionNo].mode == REGION_MAP_MODE_SLICE)
+		return logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr;
+
+	sliceOffset = logicalSliceAddr % SLICES_PER_EXTENT_REGION;
+	if(sliceOffset < extentMapPtr->region[regionNo].startSlice)
+		return VSA_NONE;
+
+	sliceOffset -= extentMapPtr->region[regionNo].startSlice;
+	if(sliceOffset < extentMapPtr->region[regionNo].length)
+		return extentMapPtr->region[regionNo].laneVsa[sliceOffset % USER_DIES] + (sliceOffset / USER_DIES) * USER_DIES;
+
+	return VSA_NONE;
+#else
+	return logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr;
+#endif
+}
+
+void UpdateLogicalSliceMap(unsigned int logicalSliceAddr, unsigned int virtualSliceAddr)
+{
+#if (EXTENT_FORWARD_MAP)
+	unsigned int regionNo, sliceOffset, length;
+
+	regionNo = logicalSliceAddr / SLICES_PER_EXTENT_REGION;
+	if(extentMapPtr->region[regionNo].mode == REGION_MAP_MODE_EXTENT)
+	{
+		sliceOffset = logicalSliceAddr % SLICES_PER_EXTENT_REGION;
+		length = extentMapPtr->region[regionNo].length;
+
+		if(virtualSliceAddr != VSA_NONE)
+		{
+			if(length == 0)
+			{
+				extentMapPtr->region[regionNo].startSlice = sliceOffset;
+				extentMapPtr->region[regionNo].laneVsa[0] = virtualSliceAddr;
+				extentMapPtr->region[regionNo].length = 1;
+				return;
+			}
+
+			//append to the tail of the extent if the slice keeps the per-die stride
+			if(sliceOffset == extentMapPtr->region[regionNo].startSlice + length)
+			{
+				if(length < USER_DIES)
+				{
+					extentMapPtr->region[regionNo].laneVsa[length] = virtualSliceAddr;
+					extentMapPtr->region[regionNo].length = length + 1;
+					return;
+				}
+				else if(virtualSliceAddr == extentMapPtr->region[regionNo].laneVsa[length % USER_DIES] + (length / USER_DIES) * USER_DIES)
+				{
+					extentMapPtr->region[regionNo].length = length + 1;
+					return;
+				}
+			}
+		}
+		else
+		{
+			if((sliceOffset < extentMapPtr->region[regionNo].startSlice) || (sliceOffset >= extentMapPtr->region[regionNo].startSlice + length))
+				return;
+			if(sliceOffset == extentMapPtr->region[regionNo].startSlice + length - 1)
+			{
+				extentMapPtr->region[regionNo].length = length - 1;
+				return;
+			}
+		}
+
+		DemoteExtentRegion(regionNo);
+	}
+#endif
+
+	logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = virtualSliceAddr;
+}
+
 unsigned int AddrTransRead(unsigned int logicalSliceAddr)
 {
 	unsigned int virtualSliceAddr;
 
 	if(logicalSliceAddr < SLICES_PER_SSD)
 	{
-		virtualSliceAddr = logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr;
+		virtualSliceAddr = LookupLogicalSliceMap(logicalSliceAddr);
 
 		if(virtualSliceAddr != VSA_NONE)
 			return virtualSliceAddr;
@@ -651,8 +785,8 @@ unsigned int AddrTransWrite(unsigned int logicalSliceAddr)
 
 		virtualSliceAddr = FindFreeVirtualSlice();
 
-		logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = virtualSliceAddr;
-		virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr = logicalSliceAddr;
+		UpdateLogicalSliceMap(logicalSliceAddr, virtualSliceAddr);
+		UpdateVirtualSliceMap(virtualSliceAddr, logicalSliceAddr);
 
 		return virtualSliceAddr;
 	}
@@ -665,12 +799,14 @@ unsigned int FindFreeVirtualSlice()
 {
 	unsigned int currentBlock, virtualSliceAddr, dieNo;
 
+	//the die is chosen when the slice is allocated, so the queue load includes every request issued so far
+	sliceAllocationTargetDie = FindDieForFreeSliceAllocation();
 	dieNo = sliceAllocationTargetDie;
 	currentBlock = virtualDieMapPtr->die[dieNo].currentBlock;
 
-	if(virtualBlockMapPtr->block[dieNo][currentBlock].currentPage == USER_PAGES_PER_BLOCK)
+	if(virtualBlockMapPtr->currentPage[dieNo][currentBlock] == USER_PAGES_PER_BLOCK)
 	{
-		currentBlock = GetFromFbList(dieNo, GET_FREE_BLOCK_NORMAL);
+		currentBlock = GetFromFbListForCurrentBlock(dieNo, GET_FREE_BLOCK_NORMAL);
 
 		if(currentBlock != BLOCK_FAIL)
 			virtualDieMapPtr->die[dieNo].currentBlock = currentBlock;
@@ -679,26 +815,27 @@ unsigned int FindFreeVirtualSlice()
 			GarbageCollection(dieNo);
 			currentBlock = virtualDieMapPtr->die[dieNo].currentBlock;
 
-			if(virtualBlockMapPtr->block[dieNo][currentBlock].currentPage == USER_PAGES_PER_BLOCK)
+			if(virtualBlockMapPtr->currentPage[dieNo][currentBlock] == USER_PAGES_PER_BLOCK)
 			{
-				currentBlock = GetFromFbList(dieNo, GET_FREE_BLOCK_NORMAL);
+				currentBlock = GetFromFbListForCurrentBlock(dieNo, GET_FREE_BLOCK_NORMAL);
 				if(currentBlock != BLOCK_FAIL)
 					virtualDieMapPtr->die[dieNo].currentBlock = currentBlock;
 				else
 					assert(!"[WARNING] There is no available block [WARNING]");
 			}
-			else if(virtualBlockMapPtr->block[dieNo][currentBlock].currentPage > USER_PAGES_PER_BLOCK)
+			else if(virtualBlockMapPtr->currentPage[dieNo][currentBlock] > USER_PAGES_PER_BLOCK)
 				assert(!"[WARNING] Current page management fail [WARNING]");
 		}
 	}
-	else if(virtualBlockMapPtr->block[dieNo][currentBlock].currentPage > USER_PAGES_PER_BLOCK)
+	else if(virtualBlockMapPtr->currentPage[dieNo][currentBlock] > USER_PAGES_PER_BLOCK)
 		assert(!"[WARNING] Current page management fail [WARNING]");
 
 
-	virtualSliceAddr = Vorg2VsaTranslation(dieNo, currentBlock, virtualBlockMapPtr->block[dieNo][currentBlock].currentPage);
-	virtualBlockMapPtr->block[dieNo][currentBlock].currentPage++;
-	sliceAllocationTargetDie = FindDieForFreeSliceAllocation();
-	dieNo = sliceAllocationTargetDie;
+	virtualSliceAddr = Vorg2VsaTranslation(dieNo, currentBlock, virtualBlockMapPtr->currentPage[dieNo][currentBlock]);
+	virtualBlockMapPtr->currentPage[dieNo][currentBlock]++;
+#if (MULTI_PLANE_OPERATION)
+	AlternateSiblingBlock(dieNo);
+#endif
 	return virtualSliceAddr;
 }
 
@@ -708,62 +845,239 @@ unsigned int FindFreeVirtualSliceForGc(unsigned int copyTargetDieNo, unsigned in
 	unsigned int currentBlock, virtualSliceAddr, dieNo;
 
 	dieNo = copyTargetDieNo;
+	if(victimBlockNo == virtualDieMapPtr->die[dieNo].siblingBlock)
+		virtualDieMapPtr->die[dieNo].siblingBlock = BLOCK_NONE;
 	if(victimBlockNo == virtualDieMapPtr->die[dieNo].currentBlock)
 	{
-		virtualDieMapPtr->die[dieNo].currentBlock = GetFromFbList(dieNo, GET_FREE_BLOCK_GC);
+		virtualDieMapPtr->die[dieNo].currentBlock = GetFromFbListForCurrentBlock(dieNo, GET_FREE_BLOCK_GC);
 		if(virtualDieMapPtr->die[dieNo].currentBlock == BLOCK_FAIL)
 			assert(!"[WARNING] There is no available block [WARNING]");
 	}
 	currentBlock = virtualDieMapPtr->die[dieNo].currentBlock;
 
-	if(virtualBlockMapPtr->block[dieNo][currentBlock].currentPage == USER_PAGES_PER_BLOCK)
+	if(virtualBlockMapPtr->currentPage[dieNo][currentBlock] == USER_PAGES_PER_BLOCK)
 	{
 
-		currentBlock = GetFromFbList(dieNo, GET_FREE_BLOCK_GC);
+		currentBlock = GetFromFbListForCurrentBlock(dieNo, GET_FREE_BLOCK_GC);
 
 		if(currentBlock != BLOCK_FAIL)
 			virtualDieMapPtr->die[dieNo].currentBlock = currentBlock;
 		else
 			assert(!"[WARNING] There is no available block [WARNING]");
 	}
-	else if(virtualBlockMapPtr->block[dieNo][currentBlock].currentPage > USER_PAGES_PER_BLOCK)
+	else if(virtualBlockMapPtr->currentPage[dieNo][currentBlock] > USER_PAGES_PER_BLOCK)
 		assert(!"[WARNING] Current page management fail [WARNING]");
 
 
-	virtualSliceAddr = Vorg2VsaTranslation(dieNo, currentBlock, virtualBlockMapPtr->block[dieNo][currentBlock].currentPage);
-	virtualBlockMapPtr->block[dieNo][currentBlock].currentPage++;
+	virtualSliceAddr = Vorg2VsaTranslation(dieNo, currentBlock, virtualBlockMapPtr->currentPage[dieNo][currentBlock]);
+	virtualBlockMapPtr->currentPage[dieNo][currentBlock]++;
+#if (MULTI_PLANE_OPERATION)
+	AlternateSiblingBlock(dieNo);
+#endif
 	return virtualSliceAddr;
 }
 
+unsigned int GetFromFbListForCurrentBlock(unsigned int dieNo, unsigned int getFreeBlockOption)
+{
+#if (MULTI_PLANE_OPERATION)
+	unsigned int blockNo;
+
+	//the replacement stays in the plane of the block it replaces, so the pair keeps spanning both planes
+	blockNo = GetFromFbListOfPlane(dieNo, getFreeBlockOption, GetPlaneOfVirtualBlock(dieNo, virtualDieMapPtr->die[dieNo].currentBlock));
+	if(blockNo != BLOCK_FAIL)
+		return blockNo;
+#endif
+	return GetFromFbList(dieNo, getFreeBlockOption);
+}
 
-unsigned int FindDieForFreeSliceAllocation()
+void AlternateSiblingBlock(unsigned int dieNo)
 {
-	static unsigned char targetCh = 0;
-	static unsigned char targetWay = 0;
-	unsigned int targetDie;
+	unsigned int currentBlock, siblingBlock;
 
-	targetDie = Pcw2VdieTranslation(targetCh, targetWay);
+	//a second open block only pays off when both planes can be programmed at once
+	if(!v2fExtOps.programPageMultiPlaneAsync)
+		return;
 
-	if(targetCh != (USER_CHANNELS - 1))
-		targetCh = targetCh + 1;
-	else
+	currentBlock = virtualDieMapPtr->die[dieNo].currentBlock;
+	siblingBlock = virtualDieMapPtr->die[dieNo].siblingBlock;
+
+	if((siblingBlock != BLOCK_NONE) && (virtualBlockMapPtr->currentPage[dieNo][siblingBlock] == USER_PAGES_PER_BLOCK))
+		siblingBlock = BLOCK_NONE;
+
+	if(siblingBlock == BLOCK_NONE)
+	{
+		//a sibling is only taken from the normal free space, it never eats into the blocks reserved for garbage collection
+		siblingBlock = GetFromFbListOfPlane(dieNo, GET_FREE_BLOCK_NORMAL, (GetPlaneOfVirtualBlock(dieNo, currentBlock) + 1) % PLANES_PER_LUN);
+		virtualDieMapPtr->die[dieNo].siblingBlock = siblingBlock;
+		if(siblingBlock == BLOCK_FAIL)
+			return;
+	}
+
+	//the next slice goes to the block that lags behind, slice k of both blocks meets at the same page offset
+	if(virtualBlockMapPtr->currentPage[dieNo][siblingBlock] <= virtualBlockMapPtr->currentPage[dieNo][currentBlock])
+	{
+		virtualDieMapPtr->die[dieNo].currentBlock = siblingBlock;
+		virtualDieMapPtr->die[dieNo].siblingBlock = currentBlock;
+	}
+}
+
+
+unsigned int GetDieLoad(unsigned int dieNo)
+{
+	unsigned int chNo, wayNo, dieLoad;
+
+	chNo = Vdie2PchTranslation(dieNo);
+	wayNo = Vdie2PwayTranslation(dieNo);
+
+	dieLoad = nandReqQ[chNo][wayNo].reqCnt + blockedByRowAddrDepReqQ[chNo][wayNo].reqCnt;
+	if(virtualDieMapPtr->die[dieNo].freeBlockCnt <= RESERVED_FREE_BLOCK_COUNT)
+		dieLoad += DIE_LOAD_GC_PENALTY;
+
+	return dieLoad;
+}
+
+//every die is selected once per stripe round, the round-robin order is kept unless the target die is overloaded
+unsigned int FindDieForFreeSliceAllocation()
+{
+	static unsigned int rrCursorDie = 0;		//channel first, then way, as Pcw2VdieTranslation numbers the dies
+	static unsigned char allocatedInStripe[USER_DIES] = {0};
+	static unsigned int allocatedDieCnt = 0;
+	unsigned int targetDie, targetDieLoad, dieNo, dieLoad, minDieLoad, minLoadDie;
+
+	if(allocatedDieCnt == USER_DIES)
 	{
-		targetCh = 0;
-		targetWay = (targetWay + 1) % USER_WAYS;
+		for(dieNo = 0; dieNo < USER_DIES; dieNo++)
+			allocatedInStripe[dieNo] = 0;
+		allocatedDieCnt = 0;
 	}
 
+	//next die of the round-robin order not allocated in this stripe
+	while(allocatedInStripe[rrCursorDie])
+		rrCursorDie = (rrCursorDie + 1) % USER_DIES;
+	targetDie = rrCursorDie;
+
+	targetDieLoad = GetDieLoad(targetDie);
+	minDieLoad = targetDieLoad;
+	minLoadDie = targetDie;
+	for(dieNo = 0; dieNo < USER_DIES; dieNo++)
+		if(!allocatedInStripe[dieNo])
+		{
+			dieLoad = GetDieLoad(dieNo);
+			if(dieLoad < minDieLoad)
+			{
+				minDieLoad = dieLoad;
+				minLoadDie = dieNo;
+			}
+		}
+
+	//the skipped round-robin target stays at the cursor and is selected later in this stripe
+	if(targetDieLoad > minDieLoad + DIE_LOAD_IMBALANCE_THRESHOLD)
+		targetDie = minLoadDie;
+
+	allocatedInStripe[targetDie] = 1;
+	allocatedDieCnt++;
+
+	//the cursor leaves a die once it is taken, so the next stripe starts after the last round-robin pick
+	if(targetDie == rrCursorDie)
+		rrCursorDie = (rrCursorDie + 1) % USER_DIES;
+
 	return targetDie;
 }
 
+void UpdateVirtualSliceMap(unsigned int virtualSliceAddr, unsigned int logicalSliceAddr)
+{
+#if (REVERSE_MAP_IN_SPARE)
+	unsigned int dieNo, blockNo, pageNo;
+
+	dieNo = Vsa2VdieTranslation(virtualSliceAddr);
+	blockNo = Vsa2VblockTranslation(virtualSliceAddr);
+	pageNo = Vsa2VpageTranslation(virtualSliceAddr);
+
+	if(logicalSliceAddr != LSA_NONE)
+		validSliceBitmapPtr->validSlice[dieNo][blockNo][pageNo / 32] |= (1u << (pageNo % 32));
+	else
+		validSliceBitmapPtr->validSlice[dieNo][blockNo][pageNo / 32] &= ~(1u << (pageNo % 32));
+#else
+	virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr = logicalSliceAddr;
+#endif
+}
+
+unsigned int CheckValidVirtualSlice(unsigned int virtualSliceAddr)
+{
+#if (REVERSE_MAP_IN_SPARE)
+	unsigned int dieNo, blockNo, pageNo;
+
+	dieNo = Vsa2VdieTranslation(virtualSliceAddr);
+	blockNo = Vsa2VblockTranslation(virtualSliceAddr);
+	pageNo = Vsa2VpageTranslation(virtualSliceAddr);
+
+	return (validSliceBitmapPtr->validSlice[dieNo][blockNo][pageNo / 32] >> (pageNo % 32)) & 1;
+#else
+	unsigned int logicalSliceAddr;
+
+	logicalSliceAddr = virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr;
+	if(logicalSliceAddr != LSA_NONE)
+		if(LookupLogicalSliceMap(logicalSliceAddr) == virtualSliceAddr)
+			return 1;
+
+	return 0;
+#endif
+}
+
+//must be called after the copy write is chained behind the copy read on the temporary data buffer entry and before either is issued
+void UpdateMapForGcCopy(unsigned int readReqSlotTag, unsigned int writeReqSlotTag)
+{
+#if (REVERSE_MAP_IN_SPARE)
+	//the lsa is known once the read brings in the spare region, CompleteGcCopyRead maps the copy then
+	reqPoolPtr->reqPool[readReqSlotTag].reqOpt.dataBufFill = REQ_OPT_DATA_BUF_FILL_GC_COPY;
+	gcCopyReadCnt++;
+#else
+	unsigned int logicalSliceAddr;
+
+	logicalSliceAddr = virtualSliceMapPtr->virtualSlice[reqPoolPtr->reqPool[readReqSlotTag].nandInfo.virtualSliceAddr].logicalSliceAddr;
+	reqPoolPtr->reqPool[writeReqSlotTag].logicalSliceAddr = logicalSliceAddr;
+
+	UpdateLogicalSliceMap(logicalSliceAddr, reqPoolPtr->reqPool[writeReqSlotTag].nandInfo.virtualSliceAddr);
+	UpdateVirtualSliceMap(reqPoolPtr->reqPool[writeReqSlotTag].nandInfo.virtualSliceAddr, logicalSliceAddr);
+#endif
+}
+
+#if (REVERSE_MAP_IN_SPARE)
+//runs when the copy read completes, the copy write is still blocked behind it and programs the lsa tag taken here
+void CompleteGcCopyRead(unsigned int readReqSlotTag)
+{
+	unsigned int logicalSliceAddr, writeReqSlotTag;
+	P_SPARE_LSA_TAG spareLsaTag;
+
+	spareLsaTag = (P_SPARE_LSA_TAG)(TEMPORARY_SPARE_DATA_BUFFER_BASE_ADDR + reqPoolPtr->reqPool[readReqSlotTag].dataBufInfo.entry * BYTES_PER_SPARE_REGION_OF_SLICE);
+	logicalSliceAddr = spareLsaTag->logicalSliceAddr;
+
+	if(logicalSliceAddr >= SLICES_PER_SSD)
+		assert(!"[WARNING] Wrong lsa tag in spare region [WARNING]");
+	if(LookupLogicalSliceMap(logicalSliceAddr) != reqPoolPtr->reqPool[readReqSlotTag].nandInfo.virtualSliceAddr)
+		assert(!"[WARNING] Lsa tag in spare region does not match the slice map [WARNING]");
+
+	writeReqSlotTag = reqPoolPtr->reqPool[readReqSlotTag].nextBlockingReq;
+	if(writeReqSlotTag == REQ_SLOT_TAG_NONE)
+		assert(!"[WARNING] Copy write is not chained to the copy read [WARNING]");
+
+	reqPoolPtr->reqPool[writeReqSlotTag].logicalSliceAddr = logicalSliceAddr;
+	UpdateLogicalSliceMap(logicalSliceAddr, reqPoolPtr->reqPool[writeReqSlotTag].nandInfo.virtualSliceAddr);
+	UpdateVirtualSliceMap(reqPoolPtr->reqPool[writeReqSlotTag].nandInfo.virtualSliceAddr, logicalSliceAddr);
+
+	gcCopyReadCnt--;
+}
+#endif
+
 void InvalidateOldVsa(unsigned int logicalSliceAddr)
 {
 	unsigned int virtualSliceAddr, dieNo, blockNo;
 
-	virtualSliceAddr = logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr;
+	virtualSliceAddr = LookupLogicalSliceMap(logicalSliceAddr);
 
 	if(virtualSliceAddr != VSA_NONE)
 	{
-		if(virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr != logicalSliceAddr)
+		if(!CheckValidVirtualSlice(virtualSliceAddr))
 			return;
 
 		dieNo = Vsa2VdieTranslation(virtualSliceAddr);
@@ -771,14 +1085,36 @@ void InvalidateOldVsa(unsigned int logicalSliceAddr)
 
 		// unlink
 		SelectiveGetFromGcVictimList(dieNo, blockNo);
-		virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt++;
-		logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = VSA_NONE;
+		virtualBlockMapPtr->invalidSliceCnt[dieNo][blockNo]++;
+		UpdateLogicalSliceMap(logicalSliceAddr, VSA_NONE);
+#if (REVERSE_MAP_IN_SPARE)
+		UpdateVirtualSliceMap(virtualSliceAddr, LSA_NONE);
+#endif
 
-		PutToGcVictimList(dieNo, blockNo, virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt);
+		PutToGcVictimList(dieNo, blockNo, virtualBlockMapPtr->invalidSliceCnt[dieNo][blockNo]);
 	}
 
 }
 
+unsigned int CheckRmwReadRequired(unsigned int logicalSliceAddr, unsigned int sectorMask)
+{
+	if(sectorMask == SECTOR_MASK_FULL)
+		return RMW_READ_NOT_REQUIRED;
+
+#if (SECTOR_VALID_TRACKING)
+	//sectors which are not held in sectorMask have never been written by host, nothing to preserve
+	if((sectorValidMapPtr->logicalSlice[logicalSliceAddr].validSectorMask & ~sectorMask) == SECTOR_MASK_NONE)
+		return RMW_READ_NOT_REQUIRED;
+#endif
+
+	return RMW_READ_REQUIRED;
+}
+
+void UpdateValidSector(unsigned int logicalSliceAddr, unsigned int nvmeBlockOffset, unsigned int numOfNvmeBlock)
+{
+	sectorValidMapPtr->logicalSlice[logicalSliceAddr].validSectorMask |= NvmeBlockRange2SectorMaskTranslation(nvmeBlockOffset, numOfNvmeBlock);
+}
+
 
 void EraseBlock(unsigned int dieNo, unsigned int blockNo)
 {
@@ -793,22 +1129,22 @@ void EraseBlock(unsigned int dieNo, unsigned int blockNo)
 	reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
 	reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
 	reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = Vorg2VsaTranslation(dieNo, blockNo, 0);
-	reqPoolPtr->reqPool[reqSlotTag].nandInfo.programmedPageCnt = virtualBlockMapPtr->block[dieNo][blockNo].currentPage;
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.programmedPageCnt = virtualBlockMapPtr->currentPage[dieNo][blockNo];
 
 	SelectLowLevelReqQ(reqSlotTag);
 
 	// block map indicated blockNo initialization
-	virtualBlockMapPtr->block[dieNo][blockNo].free = 1;
-	virtualBlockMapPtr->block[dieNo][blockNo].eraseCnt++;
-	virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt = 0;
-	virtualBlockMapPtr->block[dieNo][blockNo].currentPage = 0;
+	virtualBlockMapPtr->free[dieNo][blockNo] = 1;
+	virtualBlockMapPtr->eraseCnt[dieNo][blockNo]++;
+	virtualBlockMapPtr->invalidSliceCnt[dieNo][blockNo] = 0;
+	virtualBlockMapPtr->currentPage[dieNo][blockNo] = 0;
 
 	PutToFbList(dieNo, blockNo);
 
 	for(pageNo=0; pageNo<USER_PAGES_PER_BLOCK; pageNo++)
 	{
 		virtualSliceAddr = Vorg2VsaTranslation(dieNo, blockNo, pageNo);
-		virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr = LSA_NONE;
+		UpdateVirtualSliceMap(virtualSliceAddr, LSA_NONE);
 	}
 }
 
@@ -816,15 +1152,15 @@ void PutToFbList(unsigned int dieNo, unsigned int blockNo) //fb means free block
 {
 	if(virtualDieMapPtr->die[dieNo].tailFreeBlock != BLOCK_NONE)
 	{
-		virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = virtualDieMapPtr->die[dieNo].tailFreeBlock;
-		virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
-		virtualBlockMapPtr->block[dieNo][virtualDieMapPtr->die[dieNo].tailFreeBlock].nextBlock = blockNo;
+		virtualBlockMapPtr->prevBlock[dieNo][blockNo] = virtualDieMapPtr->die[dieNo].tailFreeBlock;
+		virtualBlockMapPtr->nextBlock[dieNo][blockNo] = BLOCK_NONE;
+		virtualBlockMapPtr->nextBlock[dieNo][virtualDieMapPtr->die[dieNo].tailFreeBlock] = blockNo;
 		virtualDieMapPtr->die[dieNo].tailFreeBlock = blockNo;
 	}
 	else
 	{
-		virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = BLOCK_NONE;
-		virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
+		virtualBlockMapPtr->prevBlock[dieNo][blockNo] = BLOCK_NONE;
+		virtualBlockMapPtr->nextBlock[dieNo][blockNo] = BLOCK_NONE;
 		virtualDieMapPtr->die[dieNo].headFreeBlock = blockNo;
 		virtualDieMapPtr->die[dieNo].tailFreeBlock = blockNo;
 	}
@@ -851,10 +1187,10 @@ unsigned int GetFromFbList(unsigned int dieNo, unsigned int getFreeBlockOption)
 	else
 		assert(!"[WARNING] Wrong getFreeBlockOption [WARNING]");
 
-	if(virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock != BLOCK_NONE)
+	if(virtualBlockMapPtr->nextBlock[dieNo][evictedBlockNo] != BLOCK_NONE)
 	{
-		virtualDieMapPtr->die[dieNo].headFreeBlock = virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock;
-		virtualBlockMapPtr->block[dieNo][virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock].prevBlock = BLOCK_NONE;
+		virtualDieMapPtr->die[dieNo].headFreeBlock = virtualBlockMapPtr->nextBlock[dieNo][evictedBlockNo];
+		virtualBlockMapPtr->prevBlock[dieNo][virtualBlockMapPtr->nextBlock[dieNo][evictedBlockNo]] = BLOCK_NONE;
 	}
 	else
 	{
@@ -862,15 +1198,58 @@ unsigned int GetFromFbList(unsigned int dieNo, unsigned int getFreeBlockOption)
 		virtualDieMapPtr->die[dieNo].tailFreeBlock = BLOCK_NONE;
 	}
 
-	virtualBlockMapPtr->block[dieNo][evictedBlockNo].free = 0;
+	virtualBlockMapPtr->free[dieNo][evictedBlockNo] = 0;
 	virtualDieMapPtr->die[dieNo].freeBlockCnt--;
 
-	virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock = BLOCK_NONE;
-	virtualBlockMapPtr->block[dieNo][evictedBlockNo].prevBlock = BLOCK_NONE;
+	virtualBlockMapPtr->nextBlock[dieNo][evictedBlockNo] = BLOCK_NONE;
+	virtualBlockMapPtr->prevBlock[dieNo][evictedBlockNo] = BLOCK_NONE;
 
 	return evictedBlockNo;
 }
 
+unsigned int GetPlaneOfVirtualBlock(unsigned int dieNo, unsigned int blockNo)
+{
+	unsigned int phyBlockNo;
+
+	phyBlockNo = phyBlockMapPtr->phyBlock[dieNo][Vblock2PblockOfTbsTranslation(blockNo)].remappedPhyBlock;
+
+	return (phyBlockNo % TOTAL_BLOCKS_PER_LUN) % PLANES_PER_LUN;
+}
+
+unsigned int GetFromFbListOfPlane(unsigned int dieNo, unsigned int getFreeBlockOption, unsigned int planeNo)
+{
+	unsigned int blockNo, prevBlockNo, nextBlockNo, scanCnt;
+
+	//move the first free block of the plane to the head of the list and take it from there
+	blockNo = virtualDieMapPtr->die[dieNo].headFreeBlock;
+	for(scanCnt = 0; (scanCnt < FREE_BLOCK_PLANE_SCAN_DEPTH) && (blockNo != BLOCK_NONE); scanCnt++)
+	{
+		if(GetPlaneOfVirtualBlock(dieNo, blockNo) == planeNo)
+		{
+			if(blockNo != virtualDieMapPtr->die[dieNo].headFreeBlock)
+			{
+				prevBlockNo = virtualBlockMapPtr->prevBlock[dieNo][blockNo];
+				nextBlockNo = virtualBlockMapPtr->nextBlock[dieNo][blockNo];
+
+				virtualBlockMapPtr->nextBlock[dieNo][prevBlockNo] = nextBlockNo;
+				if(nextBlockNo != BLOCK_NONE)
+					virtualBlockMapPtr->prevBlock[dieNo][nextBlockNo] = prevBlockNo;
+				else
+					virtualDieMapPtr->die[dieNo].tailFreeBlock = prevBlockNo;
+
+				virtualBlockMapPtr->prevBlock[dieNo][blockNo] = BLOCK_NONE;
+				virtualBlockMapPtr->nextBlock[dieNo][blockNo] = virtualDieMapPtr->die[dieNo].headFreeBlock;
+				virtualBlockMapPtr->prevBlock[dieNo][virtualDieMapPtr->die[dieNo].headFreeBlock] = blockNo;
+				virtualDieMapPtr->die[dieNo].headFreeBlock = blockNo;
+			}
+			return GetFromFbList(dieNo, getFreeBlockOption);
+		}
+		blockNo = virtualBlockMapPtr->nextBlock[dieNo][blockNo];
+	}
+
+	return BLOCK_FAIL;
+}
+
 
 void UpdatePhyBlockMapForGrownBadBlock(unsigned int dieNo, unsigned int phyBlockNo)
 {
@@ -66,9 +66,14 @@
 
 #define RESERVED_FREE_BLOCK_COUNT	0x1
 
+#define DIE_LOAD_IMBALANCE_THRESHOLD	4	//outstanding requests the striping target die may exceed the least-loaded die by
+#define DIE_LOAD_GC_PENALTY				(DIE_LOAD_IMBALANCE_THRESHOLD * 2)	//added to a die which is about to run GC
+
 #define GET_FREE_BLOCK_NORMAL	0x0
 #define GET_FREE_BLOCK_GC		0x1
 
+#define FREE_BLOCK_PLANE_SCAN_DEPTH	16		//free blocks examined for one of the requested plane
+
 #define BLOCK_STATE_NORMAL						0
 #define BLOCK_STATE_BAD							1
 
@@ -89,6 +94,20 @@
 #define BBT_INFO_GROWN_BAD_UPDATE_NONE			0
 #define BBT_INFO_GROWN_BAD_UPDATE_BOOKED		1
 
+#define SECTOR_MASK_NONE						0x0
+#define SECTOR_MASK_FULL						((1 << (NVME_BLOCKS_PER_SLICE)) - 1)
+
+#define SLICES_PER_EXTENT_REGION				(USER_DIES * SLICES_PER_BLOCK)
+#define EXTENT_REGIONS_PER_SSD					(SLICES_PER_SSD / SLICES_PER_EXTENT_REGION)
+
+#define REGION_MAP_MODE_EXTENT					0
+#define REGION_MAP_MODE_SLICE					1
+
+#define VALID_SLICE_BITMAP_WORDS_PER_BLOCK		((SLICES_PER_BLOCK + 31) / 32)
+
+#define RMW_READ_NOT_REQUIRED					0
+#define RMW_READ_REQUIRED						1
+
 // virtual slice address to virtual organization translation
 #define Vsa2VdieTranslation(virtualSliceAddr) ((virtualSliceAddr) % (USER_DIES))
 #define Vsa2VblockTranslation(virtualSliceAddr) (((virtualSliceAddr) / (USER_DIES)) / (SLICES_PER_BLOCK))
@@ -108,6 +127,9 @@
 #define Pcw2VdieTranslation(chNo, wayNo) ((chNo) + (wayNo) * (USER_CHANNELS))
 #define PlsbPage2VpageTranslation(pageNo) ((pageNo) > (0) ? ( ((pageNo) + 1) / 2): (0))
 
+// nvme block range in a slice to sector mask translation
+#define NvmeBlockRange2SectorMaskTranslation(nvmeBlockOffset, numOfNvmeBlock) ((((1 << (numOfNvmeBlock)) - 1) << (nvmeBlockOffset)) & (SECTOR_MASK_FULL))
+
 //for logical to virtual translation
 typedef struct _LOGICAL_SLICE_ENTRY {
 	unsigned int virtualSliceAddr;
@@ -118,6 +140,36 @@ typedef struct _LOGICAL_SLICE_MAP {
 } LOGICAL_SLICE_MAP, *P_LOGICAL_SLICE_MAP;
 
 
+//for extent-compressed logical to virtual translation of a sequentially written region
+//slice k of the extent is mapped to laneVsa[k % USER_DIES] + (k / USER_DIES) * USER_DIES
+//the extent map does not replace logicalSliceMap, which keeps its full reservation for regions demoted by random updates
+//it adds 40 bytes per region (80 KB next to the 16 MB flat map with 8 dies and 2048 blocks per die, about 0.5 percent more forward map metadata)
+//in return, lookups and updates of sequential regions stay in the small directory and never touch the flat map entries of those regions,
+//while every translation pays the region lookup and the first update off the per-die stride copies the extent into the flat map
+typedef struct _EXTENT_ENTRY {
+	unsigned int mode : 1;
+	unsigned int reserved0 : 15;
+	unsigned int startSlice : 16;
+	unsigned int length : 16;
+	unsigned int reserved1 : 16;
+	unsigned int laneVsa[USER_DIES];
+} EXTENT_ENTRY, *P_EXTENT_ENTRY;
+
+typedef struct _EXTENT_MAP {
+	EXTENT_ENTRY region[EXTENT_REGIONS_PER_SSD];
+} EXTENT_MAP, *P_EXTENT_MAP;
+
+
+//for sector (nvme block) validity of a logical slice
+typedef struct _SECTOR_VALID_ENTRY {
+	unsigned char validSectorMask;
+} SECTOR_VALID_ENTRY, *P_SECTOR_VALID_ENTRY;
+
+typedef struct _SECTOR_VALID_MAP {
+	SECTOR_VALID_ENTRY logicalSlice[SLICES_PER_SSD];
+} SECTOR_VALID_MAP, *P_SECTOR_VALID_MAP;
+
+
 //for virtual to logical  translation
 typedef struct _VIRTUAL_SLICE_ENTRY {
 	unsigned int logicalSliceAddr;
@@ -127,19 +179,25 @@ typedef struct _VIRTUAL_SLICE_MAP {
 	VIRTUAL_SLICE_ENTRY virtualSlice[SLICES_PER_SSD];
 } VIRTUAL_SLICE_MAP, *P_VIRTUAL_SLICE_MAP;
 
-typedef struct _VIRTUAL_BLOCK_ENTRY {
-	unsigned int bad : 1;
-	unsigned int free : 1;
-	unsigned int invalidSliceCnt : 16;
-	unsigned int reserved0 :10;
-	unsigned int currentPage : 16;
-	unsigned int eraseCnt : 16;
-	unsigned int prevBlock : 16;
-	unsigned int nextBlock :16;
-} VIRTUAL_BLOCK_ENTRY, *P_VIRTUAL_BLOCK_ENTRY;
+//for validity of virtual slices when the reverse mapping is kept in the spare region
+typedef struct _VALID_SLICE_BITMAP {
+	unsigned int validSlice[USER_DIES][USER_BLOCKS_PER_DIE][VALID_SLICE_BITMAP_WORDS_PER_BLOCK];
+} VALID_SLICE_BITMAP, *P_VALID_SLICE_BITMAP;
 
+//lsa tag recorded at the head of the spare region of every programmed slice
+typedef struct _SPARE_LSA_TAG {
+	unsigned int logicalSliceAddr;
+} SPARE_LSA_TAG, *P_SPARE_LSA_TAG;
+
+//structure of arrays, hot counters and list links do not share cache lines with cold fields
 typedef struct _VIRTUAL_BLOCK_MAP {
-	VIRTUAL_BLOCK_ENTRY block[USER_DIES][USER_BLOCKS_PER_DIE];
+	unsigned short invalidSliceCnt[USER_DIES][USER_BLOCKS_PER_DIE];
+	unsigned short currentPage[USER_DIES][USER_BLOCKS_PER_DIE];
+	unsigned short prevBlock[USER_DIES][USER_BLOCKS_PER_DIE];
+	unsigned short nextBlock[USER_DIES][USER_BLOCKS_PER_DIE];
+	unsigned short eraseCnt[USER_DIES][USER_BLOCKS_PER_DIE];
+	unsigned char bad[USER_DIES][USER_BLOCKS_PER_DIE];
+	unsigned char free[USER_DIES][USER_BLOCKS_PER_DIE];
 } VIRTUAL_BLOCK_MAP, *P_VIRTUAL_BLOCK_MAP;
 
 
@@ -150,7 +208,7 @@ typedef struct _VIRTUAL_DIE_ENTRY {
 	unsigned int freeBlockCnt : 16;
 	unsigned int prevDie : 8;
 	unsigned int nextDie : 8;
-	unsigned int reserved0 : 16;
+	unsigned int siblingBlock : 16;		//open block in the other plane, written at the page offset of the current block
 } VIRTUAL_DIE_ENTRY, *P_VIRTUAL_DIE_ENTRY;
 
 typedef struct _VIRTUAL_DIE_MAP {
@@ -188,24 +246,49 @@ void InitAddressMap();
 void InitSliceMap();
 void InitBlockDieMap();
 
+#if (EXTENT_FORWARD_MAP)
+void DemoteExtentRegion(unsigned int regionNo);
+#endif
+unsigned int LookupLogicalSliceMap(unsigned int logicalSliceAddr);
+void UpdateLogicalSliceMap(unsigned int logicalSliceAddr, unsigned int virtualSliceAddr);
+
 unsigned int AddrTransRead(unsigned int logicalSliceAddr);
 unsigned int AddrTransWrite(unsigned int logicalSliceAddr);
 unsigned int FindFreeVirtualSlice();
 unsigned int FindFreeVirtualSliceForGc(unsigned int copyTargetDieNo, unsigned int victimBlockNo);
+unsigned int GetFromFbListForCurrentBlock(unsigned int dieNo, unsigned int getFreeBlockOption);
+void AlternateSiblingBlock(unsigned int dieNo);
+unsigned int GetDieLoad(unsigned int dieNo);
 unsigned int FindDieForFreeSliceAllocation();
 
+void UpdateVirtualSliceMap(unsigned int virtualSliceAddr, unsigned int logicalSliceAddr);
+unsigned int CheckValidVirtualSlice(unsigned int virtualSliceAddr);
+void UpdateMapForGcCopy(unsigned int readReqSlotTag, unsigned int writeReqSlotTag);
+#if (REVERSE_MAP_IN_SPARE)
+void CompleteGcCopyRead(unsigned int readReqSlotTag);
+#endif
+
 void InvalidateOldVsa(unsigned int logicalSliceAddr);
+unsigned int CheckRmwReadRequired(unsigned int logicalSliceAddr, unsigned int sectorMask);
+void UpdateValidSector(unsigned int logicalSliceAddr, unsigned int nvmeBlockOffset, unsigned int numOfNvmeBlock);
 void EraseBlock(unsigned int dieNo, unsigned int blockNo);
 
 void PutToFbList(unsigned int dieNo, unsigned int blockNo);
 unsigned int GetFromFbList(unsigned int dieNo, unsigned int getFreeBlockOption);
+unsigned int GetPlaneOfVirtualBlock(unsigned int dieNo, unsigned int blockNo);
+unsigned int GetFromFbListOfPlane(unsigned int dieNo, unsigned int getFreeBlockOption, unsigned int planeNo);
 
 void UpdatePhyBlockMapForGrownBadBlock(unsigned int dieNo, unsigned int phyBlockNo);
 void UpdateBadBlockTableForGrownBadBlock(unsigned int tempBufAddr);
 
 
 extern P_LOGICAL_SLICE_MAP logicalSliceMapPtr;
+#if (EXTENT_FORWARD_MAP)
+extern P_EXTENT_MAP extentMapPtr;
+#endif
+extern P_SECTOR_VALID_MAP sectorValidMapPtr;
 extern P_VIRTUAL_SLICE_MAP virtualSliceMapPtr;
+extern P_VALID_SLICE_BITMAP validSliceBitmapPtr;
 extern P_VIRTUAL_BLOCK_MAP virtualBlockMapPtr;
 extern P_VIRTUAL_DIE_MAP virtualDieMapPtr;
 extern P_PHY_BLOCK_MAP phyBlockMapPtr;
@@ -213,5 +296,8 @@ extern P_BAD_BLOCK_TABLE_INFO_MAP bbtInfoMapPtr;
 
 extern unsigned char sliceAllocationTargetDie;
 extern unsigned int mbPerbadBlockSpace;
+#if (REVERSE_MAP_IN_SPARE)
+extern unsigned int gcCopyReadCnt;	//copy reads whose slice is not mapped to its copy yet
+#endif
 
 #endif /* ADDRESS_TRANSLATION_H_ */
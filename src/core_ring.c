@@ -0,0 +1,188 @@
+//////////////////////////////////////////////////////////////////////////////////
+// core_ring.c for Cosmos+ OpenSSD
+// Copyright (c) 2017 Hanyang University ENC Lab.
+// Contributed by Yong Ho Song <yhsong@enc.hanyang.ac.kr>
+//				  Jaewook Kwak <jwkwak@enc.hanyang.ac.kr>
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Company: ENC Lab. <http://enc.hanyang.ac.kr>
+// Engineer: Jaewook Kwak <jwkwak@enc.hanyang.ac.kr>
+//
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Inter-Core Ring
+// File Name: core_ring.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - pass request slot tags and NVMe commands between the host interface core and the FTL core
+//   - single producer and single consumer per ring, no lock is taken
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#include <assert.h>
+#include "memory_map.h"
+
+P_CORE_RING_MAP coreRingMapPtr;
+
+//orders the entry against the index which publishes it, a data memory barrier on the Cortex-A9
+#define CoreRingBarrier() __sync_synchronize()
+
+static void InitCoreSlotRing(P_CORE_SLOT_RING ring)
+{
+	ring->head = 0;
+	ring->tail = 0;
+}
+
+void InitCoreRing()
+{
+	coreRingMapPtr = (P_CORE_RING_MAP) CORE_RING_MAP_ADDR;
+
+	coreRingMapPtr->ioCmdRing.head = 0;
+	coreRingMapPtr->ioCmdRing.tail = 0;
+	InitCoreSlotRing(&coreRingMapPtr->dmaIssueRing);
+	InitCoreSlotRing(&coreRingMapPtr->dmaDoneRing);
+	InitCoreSlotRing(&coreRingMapPtr->cplRing);
+	InitCoreSlotRing(&coreRingMapPtr->rxDmaRing);
+	InitCoreSlotRing(&coreRingMapPtr->txDmaRing);
+
+	coreRingMapPtr->ftlCoreReq = FTL_CORE_REQ_NONE;
+	CoreRingBarrier();
+	coreRingMapPtr->ftlCoreState = FTL_CORE_STATE_WAIT;
+}
+
+unsigned int IsCoreSlotRingEmpty(P_CORE_SLOT_RING ring)
+{
+	return (ring->head == ring->tail);
+}
+
+void PutToCoreSlotRing(P_CORE_SLOT_RING ring, unsigned int slotTag)
+{
+	unsigned int tail, nextTail;
+
+	tail = ring->tail;
+	nextTail = (tail + 1) % CORE_SLOT_RING_ENTRY_COUNT;
+	if(nextTail == ring->head)
+		assert(!"[WARNING] Inter-core slot ring overflow [WARNING]");
+
+	ring->slot[tail] = slotTag;
+	CoreRingBarrier();
+	ring->tail = nextTail;
+}
+
+unsigned int PeekCoreSlotRing(P_CORE_SLOT_RING ring)
+{
+	unsigned int head;
+
+	head = ring->head;
+	if(head == ring->tail)
+		return REQ_SLOT_TAG_NONE;
+
+	CoreRingBarrier();
+	return ring->slot[head];
+}
+
+unsigned int GetFromCoreSlotRing(P_CORE_SLOT_RING ring)
+{
+	unsigned int head, slotTag;
+
+	head = ring->head;
+	if(head == ring->tail)
+		return REQ_SLOT_TAG_NONE;
+
+	CoreRingBarrier();
+	slotTag = ring->slot[head];
+	CoreRingBarrier();
+	ring->head = (head + 1) % CORE_SLOT_RING_ENTRY_COUNT;
+
+	return slotTag;
+}
+
+unsigned int IsCoreCmdRingFull(P_CORE_CMD_RING ring)
+{
+	return (((ring->tail + 1) % CORE_CMD_RING_ENTRY_COUNT) == ring->head);
+}
+
+unsigned int IsCoreCmdRingEmpty(P_CORE_CMD_RING ring)
+{
+	return (ring->head == ring->tail);
+}
+
+void PutToCoreCmdRing(P_CORE_CMD_RING ring, NVME_COMMAND *nvmeCmd)
+{
+	unsigned int tail, dwordIdx;
+
+	tail = ring->tail;
+	if(((tail + 1) % CORE_CMD_RING_ENTRY_COUNT) == ring->head)
+		assert(!"[WARNING] Inter-core command ring overflow [WARNING]");
+
+	ring->cmd[tail].qID = nvmeCmd->qID;
+	ring->cmd[tail].cmdSlotTag = nvmeCmd->cmdSlotTag;
+	ring->cmd[tail].cmdSeqNum = nvmeCmd->cmdSeqNum;
+	for(dwordIdx = 0; dwordIdx < 16; dwordIdx++)
+		ring->cmd[tail].cmdDword[dwordIdx] = nvmeCmd->cmdDword[dwordIdx];
+
+	CoreRingBarrier();
+	ring->tail = (tail + 1) % CORE_CMD_RING_ENTRY_COUNT;
+}
+
+unsigned int GetFromCoreCmdRing(P_CORE_CMD_RING ring, NVME_COMMAND *nvmeCmd)
+{
+	unsigned int head, dwordIdx;
+
+	head = ring->head;
+	if(head == ring->tail)
+		return 0;
+
+	CoreRingBarrier();
+	nvmeCmd->qID = ring->cmd[head].qID;
+	nvmeCmd->cmdSlotTag = ring->cmd[head].cmdSlotTag;
+	nvmeCmd->cmdSeqNum = ring->cmd[head].cmdSeqNum;
+	for(dwordIdx = 0; dwordIdx < 16; dwordIdx++)
+		nvmeCmd->cmdDword[dwordIdx] = ring->cmd[head].cmdDword[dwordIdx];
+
+	CoreRingBarrier();
+	ring->head = (head + 1) % CORE_CMD_RING_ENTRY_COUNT;
+
+	return 1;
+}
+
+unsigned int RequestFtlCore(unsigned int ftlCoreReq, unsigned int arg0, unsigned int arg1)
+{
+	coreRingMapPtr->ftlCoreReqArg[0] = arg0;
+	coreRingMapPtr->ftlCoreReqArg[1] = arg1;
+	CoreRingBarrier();
+	coreRingMapPtr->ftlCoreReq = ftlCoreReq;
+
+	//the FTL core serves the request after the IO commands passed before it, their DMA has to keep going meanwhile
+	while(coreRingMapPtr->ftlCoreReq != FTL_CORE_REQ_NONE)
+		ServiceNvmeDmaReq();
+
+	CoreRingBarrier();
+	return coreRingMapPtr->ftlCoreReqReport;
+}
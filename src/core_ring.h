@@ -0,0 +1,111 @@
+//////////////////////////////////////////////////////////////////////////////////
+// core_ring.h for Cosmos+ OpenSSD
+// Copyright (c) 2017 Hanyang University ENC Lab.
+// Contributed by Yong Ho Song <yhsong@enc.hanyang.ac.kr>
+//				  Jaewook Kwak <jwkwak@enc.hanyang.ac.kr>
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Company: ENC Lab. <http://enc.hanyang.ac.kr>
+// Engineer: Jaewook Kwak <jwkwak@enc.hanyang.ac.kr>
+//
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Inter-Core Ring
+// File Name: core_ring.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define data structure and functions of the rings between the host interface core and the FTL core
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CORE_RING_H_
+#define CORE_RING_H_
+
+#include "ftl_config.h"
+#include "request_allocation.h"
+#include "nvme/nvme.h"
+
+//every request slot fits in a slot ring, a producer never waits for its consumer to make room
+#define CORE_SLOT_RING_ENTRY_COUNT		(AVAILABLE_OUNTSTANDING_REQ_COUNT + 1)
+#define CORE_CMD_RING_ENTRY_COUNT		64
+
+#define FTL_CORE_STATE_WAIT		0
+#define FTL_CORE_STATE_RUN		1
+
+#define FTL_CORE_REQ_NONE		0
+#define FTL_CORE_REQ_SHUTDOWN	1		//write back the pinned data buffer entries and the grown bad block information
+#define FTL_CORE_REQ_PIN		2		//pin the slices of ftlCoreReqArg[0] ~ ftlCoreReqArg[0] + ftlCoreReqArg[1] - 1
+#define FTL_CORE_REQ_UNPIN		3
+
+//head is written by the consumer only and tail by the producer only, they are kept on separate cache lines
+typedef struct _CORE_SLOT_RING {
+	volatile unsigned int head;
+	unsigned int reserved0[7];
+	volatile unsigned int tail;
+	unsigned int reserved1[7];
+	unsigned short slot[CORE_SLOT_RING_ENTRY_COUNT];
+} CORE_SLOT_RING, *P_CORE_SLOT_RING;
+
+typedef struct _CORE_CMD_RING {
+	volatile unsigned int head;
+	unsigned int reserved0[7];
+	volatile unsigned int tail;
+	unsigned int reserved1[7];
+	NVME_COMMAND cmd[CORE_CMD_RING_ENTRY_COUNT];
+} CORE_CMD_RING, *P_CORE_CMD_RING;
+
+typedef struct _CORE_RING_MAP {
+	CORE_CMD_RING ioCmdRing;			//host interface core -> FTL core, fetched IO commands, admitted by the FTL core
+	CORE_SLOT_RING dmaIssueRing;		//FTL core -> host interface core, DMA requests to be issued
+	CORE_SLOT_RING dmaDoneRing;			//host interface core -> FTL core, finished DMA requests to be released
+	CORE_SLOT_RING cplRing;				//FTL core -> host interface core, NVMe command slots completed without data transfer
+	CORE_SLOT_RING rxDmaRing;			//host interface core only, issued host-to-device DMA requests in issue order
+	CORE_SLOT_RING txDmaRing;			//host interface core only, issued device-to-host DMA requests in issue order
+	volatile unsigned int ftlCoreState;
+	volatile unsigned int ftlCoreReq;			//set by the host interface core, cleared by the FTL core when it is served
+	volatile unsigned int ftlCoreReqArg[2];
+	volatile unsigned int ftlCoreReqReport;
+} CORE_RING_MAP, *P_CORE_RING_MAP;
+
+void InitCoreRing();
+
+unsigned int IsCoreSlotRingEmpty(P_CORE_SLOT_RING ring);
+void PutToCoreSlotRing(P_CORE_SLOT_RING ring, unsigned int slotTag);
+unsigned int PeekCoreSlotRing(P_CORE_SLOT_RING ring);
+unsigned int GetFromCoreSlotRing(P_CORE_SLOT_RING ring);
+
+unsigned int IsCoreCmdRingFull(P_CORE_CMD_RING ring);
+unsigned int IsCoreCmdRingEmpty(P_CORE_CMD_RING ring);
+void PutToCoreCmdRing(P_CORE_CMD_RING ring, NVME_COMMAND *nvmeCmd);
+unsigned int GetFromCoreCmdRing(P_CORE_CMD_RING ring, NVME_COMMAND *nvmeCmd);
+
+unsigned int RequestFtlCore(unsigned int ftlCoreReq, unsigned int arg0, unsigned int arg1);
+
+extern P_CORE_RING_MAP coreRingMapPtr;
+
+#endif /* CORE_RING_H_ */
@@ -50,36 +50,81 @@
 
 
 P_DATA_BUF_MAP dataBufMapPtr;
-DATA_BUF_LRU_LIST dataBufLruList;
+DATA_BUF_LRU_LIST dataBufLruList[DATA_BUF_LIST_COUNT];
 P_DATA_BUF_HASH_TABLE dataBufHashTablePtr;
 P_TEMPORARY_DATA_BUF_MAP tempDataBufMapPtr;
+unsigned int dataBufEntryCnt;
+unsigned int dataBufHashShift;
+unsigned int dirtyDataBufCnt;
+unsigned int dataBufTenantEntryCnt[DATA_BUF_TENANT_COUNT];
+unsigned int pinnedDataBufCnt;
+unsigned int dataBufRefSeq;
 
 void InitDataBuf()
 {
 	int bufEntry;
+	unsigned int hashBucketCnt;
 
 	dataBufMapPtr = (P_DATA_BUF_MAP) DATA_BUFFER_MAP_ADDR;
 	dataBufHashTablePtr = (P_DATA_BUF_HASH_TABLE)DATA_BUFFFER_HASH_TABLE_ADDR;
 	tempDataBufMapPtr = (P_TEMPORARY_DATA_BUF_MAP)TEMPORARY_DATA_BUFFER_MAP_ADDR;
 
-	for(bufEntry = 0; bufEntry < AVAILABLE_DATA_BUFFER_ENTRY_COUNT; bufEntry++)
+	//every slice of DRAM between the fixed-size buffers and the NAND completion tables becomes a data buffer entry
+	dataBufEntryCnt = (COMPLETE_FLAG_TABLE_ADDR - DATA_BUFFER_BASE_ADDR - RESERVED_DATA_BUFFER_BYTES) / (BYTES_PER_DATA_REGION_OF_SLICE + BYTES_PER_SPARE_REGION_OF_SLICE)
+			- AVAILABLE_TEMPORARY_DATA_BUFFER_ENTRY_COUNT;
+	if(dataBufEntryCnt > DATA_BUFFER_ENTRY_COUNT_CAP)
+		dataBufEntryCnt = DATA_BUFFER_ENTRY_COUNT_CAP;
+
+	xil_printf("[ data buffer entries: %d (%d MB) ]\r\n", dataBufEntryCnt, dataBufEntryCnt * BYTES_PER_DATA_REGION_OF_SLICE / (1024 * 1024));
+
+	//at least one bucket per entry
+	hashBucketCnt = 2;
+	dataBufHashShift = 31;
+	while(hashBucketCnt < dataBufEntryCnt)
+	{
+		hashBucketCnt <<= 1;
+		dataBufHashShift--;
+	}
+
+	for(bufEntry = 0; bufEntry < hashBucketCnt; bufEntry++)
+	{
+		dataBufHashTablePtr->dataBufHash[bufEntry].headEntry = DATA_BUF_NONE;
+		dataBufHashTablePtr->dataBufHash[bufEntry].tailEntry = DATA_BUF_NONE;
+	}
+
+	for(bufEntry = 0; bufEntry < dataBufEntryCnt; bufEntry++)
 	{
 		dataBufMapPtr->dataBuf[bufEntry].logicalSliceAddr = LSA_NONE;
 		dataBufMapPtr->dataBuf[bufEntry].prevEntry = bufEntry-1;
 		dataBufMapPtr->dataBuf[bufEntry].nextEntry = bufEntry+1;
 		dataBufMapPtr->dataBuf[bufEntry].dirty = DATA_BUF_CLEAN;
+		dataBufMapPtr->dataBuf[bufEntry].lruList = DATA_BUF_LIST_PROBATION;
+		dataBufMapPtr->dataBuf[bufEntry].prefetched = 0;
+		dataBufMapPtr->dataBuf[bufEntry].sectorValidMask = SECTOR_MASK_NONE;
+		dataBufMapPtr->dataBuf[bufEntry].tenantNo = DATA_BUF_TENANT_NONE;
+		dataBufMapPtr->dataBuf[bufEntry].fastPathTx = 0;
+		dataBufMapPtr->dataBuf[bufEntry].pinned = 0;
+		dataBufMapPtr->dataBuf[bufEntry].refSeq = 0;
 		dataBufMapPtr->dataBuf[bufEntry].blockingReqTail =  REQ_SLOT_TAG_NONE;
 
-		dataBufHashTablePtr->dataBufHash[bufEntry].headEntry = DATA_BUF_NONE;
-		dataBufHashTablePtr->dataBufHash[bufEntry].tailEntry = DATA_BUF_NONE;
 		dataBufMapPtr->dataBuf[bufEntry].hashPrevEntry = DATA_BUF_NONE;
 		dataBufMapPtr->dataBuf[bufEntry].hashNextEntry = DATA_BUF_NONE;
 	}
 
 	dataBufMapPtr->dataBuf[0].prevEntry = DATA_BUF_NONE;
-	dataBufMapPtr->dataBuf[AVAILABLE_DATA_BUFFER_ENTRY_COUNT - 1].nextEntry = DATA_BUF_NONE;
-	dataBufLruList.headEntry = 0 ;
-	dataBufLruList.tailEntry = AVAILABLE_DATA_BUFFER_ENTRY_COUNT - 1;
+	dataBufMapPtr->dataBuf[dataBufEntryCnt - 1].nextEntry = DATA_BUF_NONE;
+	dataBufLruList[DATA_BUF_LIST_PROBATION].headEntry = 0 ;
+	dataBufLruList[DATA_BUF_LIST_PROBATION].tailEntry = dataBufEntryCnt - 1;
+	dataBufLruList[DATA_BUF_LIST_PROBATION].entryCnt = dataBufEntryCnt;
+	dataBufLruList[DATA_BUF_LIST_PROTECTED].headEntry = DATA_BUF_NONE;
+	dataBufLruList[DATA_BUF_LIST_PROTECTED].tailEntry = DATA_BUF_NONE;
+	dataBufLruList[DATA_BUF_LIST_PROTECTED].entryCnt = 0;
+	dirtyDataBufCnt = 0;
+	pinnedDataBufCnt = 0;
+	dataBufRefSeq = 0;
+
+	for(bufEntry = 0; bufEntry < DATA_BUF_TENANT_COUNT; bufEntry++)
+		dataBufTenantEntryCnt[bufEntry] = 0;
 
 	for(bufEntry = 0; bufEntry < AVAILABLE_TEMPORARY_DATA_BUFFER_ENTRY_COUNT; bufEntry++)
 		tempDataBufMapPtr->tempDataBuf[bufEntry].blockingReqTail =  REQ_SLOT_TAG_NONE;
@@ -87,91 +132,140 @@ void InitDataBuf()
 
 unsigned int CheckDataBufHit(unsigned int reqSlotTag)
 {
-	unsigned int bufEntry, logicalSliceAddr;
+	unsigned int bufEntry;
+
+	bufEntry = LookupDataBuf(reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr);
+	if(bufEntry == DATA_BUF_FAIL)
+		return DATA_BUF_FAIL;
+
+	TouchDataBuf(bufEntry);
+
+	return bufEntry;
+}
+
+void TouchDataBuf(unsigned int bufEntry)
+{
+	unsigned int lruList, correlatedRef;
+
+	if(dataBufMapPtr->dataBuf[bufEntry].pinned)
+		return ;
+
+	correlatedRef = (((dataBufRefSeq - dataBufMapPtr->dataBuf[bufEntry].refSeq) & DATA_BUF_REF_SEQ_MASK) <= DATA_BUF_CORRELATED_REF_WINDOW);
+	dataBufMapPtr->dataBuf[bufEntry].refSeq = dataBufRefSeq++;
+
+	lruList = dataBufMapPtr->dataBuf[bufEntry].lruList;
+	SelectiveGetFromDataBufLruList(bufEntry);
+
+	if(dataBufMapPtr->dataBuf[bufEntry].prefetched)
+	{
+		//the first reference to read-ahead data is not a re-reference, keep it on probation
+		dataBufMapPtr->dataBuf[bufEntry].prefetched = 0;
+		PutToDataBufLruList(bufEntry, DATA_BUF_LIST_PROBATION);
+	}
+	else if(correlatedRef)
+	{
+		//a correlated reference only refreshes the entry in its own list
+		PutToDataBufLruList(bufEntry, lruList);
+	}
+	else
+	{
+		//a re-referenced entry is promoted to the protected list, so a single sequential scan only churns the probation list
+		PutToDataBufLruList(bufEntry, DATA_BUF_LIST_PROTECTED);
+
+		if(dataBufLruList[DATA_BUF_LIST_PROTECTED].entryCnt > PROTECTED_DATA_BUF_ENTRY_COUNT_MAX)
+		{
+			unsigned int demotedEntry = dataBufLruList[DATA_BUF_LIST_PROTECTED].tailEntry;
+
+			SelectiveGetFromDataBufLruList(demotedEntry);
+			PutToDataBufLruList(demotedEntry, DATA_BUF_LIST_PROBATION);
+		}
+	}
+}
+
+unsigned int LookupDataBuf(unsigned int logicalSliceAddr)
+{
+	unsigned int bufEntry;
 
-	logicalSliceAddr = reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr;
 	bufEntry = dataBufHashTablePtr->dataBufHash[FindDataBufHashTableEntry(logicalSliceAddr)].headEntry;
 
 	while(bufEntry != DATA_BUF_NONE)
 	{
 		if(dataBufMapPtr->dataBuf[bufEntry].logicalSliceAddr == logicalSliceAddr)
+			return bufEntry;
+
+		bufEntry = dataBufMapPtr->dataBuf[bufEntry].hashNextEntry;
+	}
+
+	return DATA_BUF_FAIL;
+}
+
+unsigned int SelectDataBufVictim(unsigned int tenantNo)
+{
+	unsigned int bufEntry, lruList;
+
+	for(lruList = DATA_BUF_LIST_PROBATION; lruList < DATA_BUF_LIST_COUNT; lruList++)
+	{
+		bufEntry = dataBufLruList[lruList].tailEntry;
+
+#if (DATA_BUF_PARTITION)
+		//an entry is taken from its tenant only if it is the requester itself or the tenant is using the shared overflow
+		while(bufEntry != DATA_BUF_NONE)
 		{
-			if((dataBufMapPtr->dataBuf[bufEntry].nextEntry != DATA_BUF_NONE) && (dataBufMapPtr->dataBuf[bufEntry].prevEntry != DATA_BUF_NONE))
-			{
-				dataBufMapPtr->dataBuf[dataBufMapPtr->dataBuf[bufEntry].prevEntry].nextEntry = dataBufMapPtr->dataBuf[bufEntry].nextEntry;
-				dataBufMapPtr->dataBuf[dataBufMapPtr->dataBuf[bufEntry].nextEntry].prevEntry = dataBufMapPtr->dataBuf[bufEntry].prevEntry;
-			}
-			else if((dataBufMapPtr->dataBuf[bufEntry].nextEntry == DATA_BUF_NONE) && (dataBufMapPtr->dataBuf[bufEntry].prevEntry != DATA_BUF_NONE))
-			{
-				dataBufMapPtr->dataBuf[dataBufMapPtr->dataBuf[bufEntry].prevEntry].nextEntry = DATA_BUF_NONE;
-				dataBufLruList.tailEntry = dataBufMapPtr->dataBuf[bufEntry].prevEntry;
-			}
-			else if((dataBufMapPtr->dataBuf[bufEntry].nextEntry != DATA_BUF_NONE) && (dataBufMapPtr->dataBuf[bufEntry].prevEntry== DATA_BUF_NONE))
-			{
-				dataBufMapPtr->dataBuf[dataBufMapPtr->dataBuf[bufEntry].nextEntry].prevEntry  = DATA_BUF_NONE;
-				dataBufLruList.headEntry = dataBufMapPtr->dataBuf[bufEntry].nextEntry;
-			}
-			else
-			{
-				dataBufLruList.tailEntry = DATA_BUF_NONE;
-				dataBufLruList.headEntry = DATA_BUF_NONE;
-			}
-
-			if(dataBufLruList.headEntry != DATA_BUF_NONE)
-			{
-				dataBufMapPtr->dataBuf[bufEntry].prevEntry = DATA_BUF_NONE;
-				dataBufMapPtr->dataBuf[bufEntry].nextEntry = dataBufLruList.headEntry;
-				dataBufMapPtr->dataBuf[dataBufLruList.headEntry].prevEntry = bufEntry;
-				dataBufLruList.headEntry = bufEntry;
-			}
-			else
-			{
-				dataBufMapPtr->dataBuf[bufEntry].prevEntry = DATA_BUF_NONE;
-				dataBufMapPtr->dataBuf[bufEntry].nextEntry = DATA_BUF_NONE;
-				dataBufLruList.headEntry = bufEntry;
-				dataBufLruList.tailEntry = bufEntry;
-			}
+			unsigned int victimTenantNo = dataBufMapPtr->dataBuf[bufEntry].tenantNo;
+			if((victimTenantNo == DATA_BUF_TENANT_NONE) || (victimTenantNo == tenantNo) || (dataBufTenantEntryCnt[victimTenantNo] > DATA_BUF_TENANT_QUOTA))
+				return bufEntry;
 
-			return bufEntry;
+			bufEntry = dataBufMapPtr->dataBuf[bufEntry].prevEntry;
 		}
-		else
-			bufEntry = dataBufMapPtr->dataBuf[bufEntry].hashNextEntry;
+#else
+		if(bufEntry != DATA_BUF_NONE)
+			return bufEntry;
+#endif
 	}
 
-	return DATA_BUF_FAIL;
+	return DATA_BUF_NONE;
 }
 
-unsigned int AllocateDataBuf()
+unsigned int AllocateDataBuf(unsigned int tenantNo)
 {
-	unsigned int evictedEntry = dataBufLruList.tailEntry;
+	unsigned int evictedEntry = SelectDataBufVictim(tenantNo);
 
 	if(evictedEntry == DATA_BUF_NONE)
 		assert(!"[WARNING] There is no valid buffer entry [WARNING]");
 
-	if(dataBufMapPtr->dataBuf[evictedEntry].prevEntry != DATA_BUF_NONE)
-	{
-		dataBufMapPtr->dataBuf[dataBufMapPtr->dataBuf[evictedEntry].prevEntry].nextEntry = DATA_BUF_NONE;
-		dataBufLruList.tailEntry = dataBufMapPtr->dataBuf[evictedEntry].prevEntry;
-
-		dataBufMapPtr->dataBuf[evictedEntry].prevEntry = DATA_BUF_NONE;
-		dataBufMapPtr->dataBuf[evictedEntry].nextEntry = dataBufLruList.headEntry;
-		dataBufMapPtr->dataBuf[dataBufLruList.headEntry].prevEntry = evictedEntry;
-		dataBufLruList.headEntry = evictedEntry;
+	SyncReleaseFastPathTxDma(evictedEntry);
 
-	}
-	else
-	{
-		dataBufMapPtr->dataBuf[evictedEntry].prevEntry = DATA_BUF_NONE;
-		dataBufMapPtr->dataBuf[evictedEntry].nextEntry = DATA_BUF_NONE;
-		dataBufLruList.headEntry = evictedEntry;
-		dataBufLruList.tailEntry = evictedEntry;
-	}
+	SelectiveGetFromDataBufLruList(evictedEntry);
+	PutToDataBufLruList(evictedEntry, DATA_BUF_LIST_PROBATION);
 
 	SelectiveGetFromDataBufHashList(evictedEntry);
+	dataBufMapPtr->dataBuf[evictedEntry].prefetched = 0;
+	dataBufMapPtr->dataBuf[evictedEntry].refSeq = dataBufRefSeq++;	//the miss is the first reference
+
+	if(dataBufMapPtr->dataBuf[evictedEntry].tenantNo != DATA_BUF_TENANT_NONE)
+		dataBufTenantEntryCnt[dataBufMapPtr->dataBuf[evictedEntry].tenantNo]--;
+	dataBufMapPtr->dataBuf[evictedEntry].tenantNo = tenantNo;
+	if(tenantNo != DATA_BUF_TENANT_NONE)
+		dataBufTenantEntryCnt[tenantNo]++;
 
 	return evictedEntry;
 }
 
+unsigned int AllocateCleanDataBuf(unsigned int tenantNo)
+{
+	unsigned int evictedEntry = SelectDataBufVictim(tenantNo);
+
+	//speculative allocation never writes back a dirty entry or shrinks the protected list
+	if(evictedEntry == DATA_BUF_NONE)
+		return DATA_BUF_FAIL;
+	if(dataBufMapPtr->dataBuf[evictedEntry].lruList != DATA_BUF_LIST_PROBATION)
+		return DATA_BUF_FAIL;
+	if(dataBufMapPtr->dataBuf[evictedEntry].dirty == DATA_BUF_DIRTY)
+		return DATA_BUF_FAIL;
+
+	return AllocateDataBuf(tenantNo);
+}
+
 
 void UpdateDataBufEntryInfoBlockingReq(unsigned int bufEntry, unsigned int reqSlotTag)
 {
@@ -203,6 +297,61 @@ void UpdateTempDataBufEntryInfoBlockingReq(unsigned int bufEntry, unsigned int r
 	tempDataBufMapPtr->tempDataBuf[bufEntry].blockingReqTail = reqSlotTag;
 }
 
+void PutToDataBufLruList(unsigned int bufEntry, unsigned int lruList)
+{
+	if(dataBufLruList[lruList].headEntry != DATA_BUF_NONE)
+	{
+		dataBufMapPtr->dataBuf[bufEntry].prevEntry = DATA_BUF_NONE;
+		dataBufMapPtr->dataBuf[bufEntry].nextEntry = dataBufLruList[lruList].headEntry;
+		dataBufMapPtr->dataBuf[dataBufLruList[lruList].headEntry].prevEntry = bufEntry;
+		dataBufLruList[lruList].headEntry = bufEntry;
+	}
+	else
+	{
+		dataBufMapPtr->dataBuf[bufEntry].prevEntry = DATA_BUF_NONE;
+		dataBufMapPtr->dataBuf[bufEntry].nextEntry = DATA_BUF_NONE;
+		dataBufLruList[lruList].headEntry = bufEntry;
+		dataBufLruList[lruList].tailEntry = bufEntry;
+	}
+
+	dataBufMapPtr->dataBuf[bufEntry].lruList = lruList;
+	dataBufLruList[lruList].entryCnt++;
+}
+
+
+void SelectiveGetFromDataBufLruList(unsigned int bufEntry)
+{
+	unsigned int prevBufEntry, nextBufEntry, lruList;
+
+	prevBufEntry = dataBufMapPtr->dataBuf[bufEntry].prevEntry;
+	nextBufEntry = dataBufMapPtr->dataBuf[bufEntry].nextEntry;
+	lruList = dataBufMapPtr->dataBuf[bufEntry].lruList;
+
+	if((nextBufEntry != DATA_BUF_NONE) && (prevBufEntry != DATA_BUF_NONE))
+	{
+		dataBufMapPtr->dataBuf[prevBufEntry].nextEntry = nextBufEntry;
+		dataBufMapPtr->dataBuf[nextBufEntry].prevEntry = prevBufEntry;
+	}
+	else if((nextBufEntry == DATA_BUF_NONE) && (prevBufEntry != DATA_BUF_NONE))
+	{
+		dataBufMapPtr->dataBuf[prevBufEntry].nextEntry = DATA_BUF_NONE;
+		dataBufLruList[lruList].tailEntry = prevBufEntry;
+	}
+	else if((nextBufEntry != DATA_BUF_NONE) && (prevBufEntry == DATA_BUF_NONE))
+	{
+		dataBufMapPtr->dataBuf[nextBufEntry].prevEntry = DATA_BUF_NONE;
+		dataBufLruList[lruList].headEntry = nextBufEntry;
+	}
+	else
+	{
+		dataBufLruList[lruList].headEntry = DATA_BUF_NONE;
+		dataBufLruList[lruList].tailEntry = DATA_BUF_NONE;
+	}
+
+	dataBufLruList[lruList].entryCnt--;
+}
+
+
 void PutToDataBufHashList(unsigned int bufEntry)
 {
 	unsigned int hashEntry;
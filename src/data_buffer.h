@@ -49,15 +49,50 @@
 
 #include "ftl_config.h"
 
-#define AVAILABLE_DATA_BUFFER_ENTRY_COUNT				(16 * USER_DIES)
+//data buffer entries fill what the temporary and reserved buffers leave of the data buffer region, InitDataBuf caps the count with DATA_BUF_ENTRIES_PER_DIE_MAX
+//the cap bounds the entry walks (pin flush, partition victim scan) and the dirty data exposed to a power loss, the watermarks below scale with the count
+#define DATA_BUFFER_REGION_BYTES						0x07000000		//from DATA_BUFFER_BASE_ADDR to COMPLETE_FLAG_TABLE_ADDR
+#define RESERVED_DATA_BUFFER_BYTES						0x00200000
 #define AVAILABLE_TEMPORARY_DATA_BUFFER_ENTRY_COUNT		(USER_DIES)
+#define MAX_DATA_BUFFER_ENTRY_COUNT						((DATA_BUFFER_REGION_BYTES - RESERVED_DATA_BUFFER_BYTES) / (BYTES_PER_DATA_REGION_OF_SLICE + BYTES_PER_SPARE_REGION_OF_SLICE) - AVAILABLE_TEMPORARY_DATA_BUFFER_ENTRY_COUNT)
+#define DATA_BUFFER_ENTRY_COUNT_CAP						(DATA_BUF_ENTRIES_PER_DIE_MAX * USER_DIES)
 
 #define DATA_BUF_NONE	0xffff
 #define DATA_BUF_FAIL	0xffff
 #define DATA_BUF_DIRTY	1
 #define DATA_BUF_CLEAN	0
 
-#define FindDataBufHashTableEntry(logicalSliceAddr) ((logicalSliceAddr) % AVAILABLE_DATA_BUFFER_ENTRY_COUNT)
+//2Q replacement: entries enter the probation list and are promoted to the protected list on a re-reference
+#define DATA_BUF_LIST_PROBATION		0
+#define DATA_BUF_LIST_PROTECTED		1
+#define DATA_BUF_LIST_COUNT			2
+
+#define PROTECTED_DATA_BUF_ENTRY_COUNT_MAX		(dataBufEntryCnt * 3 / 4)
+
+//a reference within this many data buffer references of the previous one to the same entry is correlated and does not promote it,
+//e.g. the four 4 KB reads of a sequential scan over one slice, interleaved with a few other streams
+#define DATA_BUF_CORRELATED_REF_WINDOW	(USER_DIES * 8)
+#define DATA_BUF_REF_SEQ_MASK			0xffff
+
+//background write-back starts above the high watermark and keeps cleaning until the low watermark
+#define DIRTY_DATA_BUF_HIGH_WATERMARK	(dataBufEntryCnt / 2)
+#define DIRTY_DATA_BUF_LOW_WATERMARK	(dataBufEntryCnt / 4)
+#define WRITE_BACK_BATCH_SIZE			(USER_DIES)		//one program per die
+#define WRITE_BACK_SCAN_DEPTH			(WRITE_BACK_BATCH_SIZE * 4)
+
+//partitioned data buffer, half of the entries are split into per-tenant quotas and the other half is shared overflow
+#define DATA_BUF_TENANT_COUNT		8		//one tenant per NVMe IO submission queue
+#define DATA_BUF_TENANT_NONE		0xf
+#define DATA_BUF_TENANT_QUOTA		(dataBufEntryCnt / 2 / DATA_BUF_TENANT_COUNT)
+
+//multiplicative hashing over a power-of-two bucket count, the top bits of the product select the bucket
+#define DATA_BUF_HASH_TABLE_SIZE		(MAX_DATA_BUFFER_ENTRY_COUNT * 2)	//room for the next power of two above the entry count
+#define DATA_BUF_HASH_MULTIPLIER		0x9E3779B1							//2^32 divided by the golden ratio
+
+//entries pinned by the vendor pin command leave the LRU lists until they are unpinned
+#define DATA_BUF_PIN_ENTRY_COUNT_MAX	(dataBufEntryCnt / 8)	//keeps most of the pool for host requests
+
+#define FindDataBufHashTableEntry(logicalSliceAddr) (((unsigned int)(logicalSliceAddr) * DATA_BUF_HASH_MULTIPLIER) >> dataBufHashShift)
 
 
 typedef struct _DATA_BUF_ENTRY {
@@ -68,16 +103,25 @@ typedef struct _DATA_BUF_ENTRY {
 	unsigned int hashPrevEntry : 16;
 	unsigned int hashNextEntry : 16;
 	unsigned int dirty : 1;
+	unsigned int lruList : 1;
+	unsigned int prefetched : 1;
+	unsigned int sectorValidMask : 8;	//sectors holding host or NAND data, the rest is filled in before the entry is programmed
+	unsigned int tenantNo : 4;
+	unsigned int fastPathTx : 1;		//host DMA issued by the read hit fast path may still read this entry
+	unsigned int pinned : 1;			//not on any LRU list, written back only on flush and shutdown
+	unsigned int refSeq : 16;			//low bits of dataBufRefSeq at the latest reference
 	unsigned int reserved0 : 15;
 } DATA_BUF_ENTRY, *P_DATA_BUF_ENTRY;
 
 typedef struct _DATA_BUF_MAP{
-	DATA_BUF_ENTRY dataBuf[AVAILABLE_DATA_BUFFER_ENTRY_COUNT];
+	DATA_BUF_ENTRY dataBuf[MAX_DATA_BUFFER_ENTRY_COUNT];
 } DATA_BUF_MAP, *P_DATA_BUF_MAP;
 
 typedef struct _DATA_BUF_LRU_LIST {
 	unsigned int headEntry : 16;
 	unsigned int tailEntry : 16;
+	unsigned int entryCnt : 16;
+	unsigned int reserved0 : 16;
 } DATA_BUF_LRU_LIST, *P_DATA_BUF_LRU_LIST;
 
 typedef struct _DATA_BUF_HASH_ENTRY{
@@ -87,7 +131,7 @@ typedef struct _DATA_BUF_HASH_ENTRY{
 
 
 typedef struct _DATA_BUF_HASH_TABLE{
-	DATA_BUF_HASH_ENTRY dataBufHash[AVAILABLE_DATA_BUFFER_ENTRY_COUNT];
+	DATA_BUF_HASH_ENTRY dataBufHash[DATA_BUF_HASH_TABLE_SIZE];
 } DATA_BUF_HASH_TABLE, *P_DATA_BUF_HASH_TABLE;
 
 
@@ -102,18 +146,30 @@ typedef struct _TEMPORARY_DATA_BUF_MAP{
 
 void InitDataBuf();
 unsigned int CheckDataBufHit(unsigned int reqSlotTag);
-unsigned int AllocateDataBuf();
+void TouchDataBuf(unsigned int bufEntry);
+unsigned int SelectDataBufVictim(unsigned int tenantNo);
+unsigned int AllocateDataBuf(unsigned int tenantNo);
+unsigned int AllocateCleanDataBuf(unsigned int tenantNo);
+unsigned int LookupDataBuf(unsigned int logicalSliceAddr);
 void UpdateDataBufEntryInfoBlockingReq(unsigned int bufEntry, unsigned int reqSlotTag);
 
 unsigned int AllocateTempDataBuf(unsigned int dieNo);
 void UpdateTempDataBufEntryInfoBlockingReq(unsigned int bufEntry, unsigned int reqSlotTag);
 
+void PutToDataBufLruList(unsigned int bufEntry, unsigned int lruList);
+void SelectiveGetFromDataBufLruList(unsigned int bufEntry);
 void PutToDataBufHashList(unsigned int bufEntry);
 void SelectiveGetFromDataBufHashList(unsigned int bufEntry);
 
 extern P_DATA_BUF_MAP dataBufMapPtr;
-extern DATA_BUF_LRU_LIST dataBufLruList;
+extern DATA_BUF_LRU_LIST dataBufLruList[DATA_BUF_LIST_COUNT];
 extern P_DATA_BUF_HASH_TABLE dataBufHashTable;
 extern P_TEMPORARY_DATA_BUF_MAP tempDataBufMapPtr;
+extern unsigned int dataBufEntryCnt;
+extern unsigned int dataBufHashShift;
+extern unsigned int dirtyDataBufCnt;
+extern unsigned int dataBufTenantEntryCnt[DATA_BUF_TENANT_COUNT];
+extern unsigned int pinnedDataBufCnt;
+extern unsigned int dataBufRefSeq;
 
 #endif /* DATA_BUFFER_H_ */
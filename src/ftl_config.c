@@ -67,6 +67,7 @@ void InitFTL()
 	InitNandArray();
 	InitAddressMap();
 	InitDataBuf();
+	InitReadAhead();
 	InitGcVictimMap();
 
 	storageCapacity_L = (MB_PER_SSD - (MB_PER_MIN_FREE_BLOCK_SPACE + mbPerbadBlockSpace + MB_PER_OVER_PROVISION_BLOCK_SPACE)) * ((1024*1024) / BYTES_PER_NVME_BLOCK);
@@ -197,11 +198,21 @@ void CheckConfigRestriction()
 		assert(!"[WARNING] Configuration Error: BLOCK [WARNING]");
 	if((BITS_PER_FLASH_CELL != SLC_MODE))
 		assert(!"[WARNING] Configuration Error: BIT_PER_FLASH_CELL [WARNING]");
+	if(NVME_BLOCKS_PER_SLICE > 8)
+		assert(!"[WARNING] Configuration Error: Sector valid mask is too small to cover a slice [WARNING]");
+#if (EXTENT_FORWARD_MAP)
+	if(SLICES_PER_EXTENT_REGION > 0xffff)
+		assert(!"[WARNING] Configuration Error: Extent region is too large [WARNING]");
+#endif
 
-	if(RESERVED_DATA_BUFFER_BASE_ADDR + 0x00200000 > COMPLETE_FLAG_TABLE_ADDR)
+	if(MAX_DATA_BUFFER_ENTRY_COUNT >= DATA_BUF_NONE)
+		assert(!"[WARNING] Configuration Error: Data buffer has more entries than its 16-bit links can address [WARNING]");
+	if(RESERVED_DATA_BUFFER_BASE_ADDR + RESERVED_DATA_BUFFER_BYTES > COMPLETE_FLAG_TABLE_ADDR)
 		assert(!"[WARNING] Configuration Error: Data buffer size is too large to be allocated to predefined range [WARNING]");
 	if(TEMPORARY_PAY_LOAD_ADDR + 0x00001000 > DATA_BUFFER_MAP_ADDR)
 		assert(!"[WARNING] Configuration Error: Metadata for NAND request completion process is too large to be allocated to predefined range [WARNING]");
+	if(CORE_RING_MAP_ADDR + sizeof(CORE_RING_MAP) > RESERVED0_END_ADDR)
+		assert(!"[WARNING] Configuration Error: Inter-core rings are too large to be allocated to predefined range [WARNING]");
 	if(FTL_MANAGEMENT_END_ADDR > DRAM_END_ADDR)
 		assert(!"[WARNING] Configuration Error: Metadata of FTL is too large to be allocated to DRAM [WARNING]");
 }
@@ -148,6 +148,7 @@
 #define	MAIN_ROWS_PER_MLC_LUN		(ROWS_PER_MLC_BLOCK * MAIN_BLOCKS_PER_LUN)
 
 #define	LUNS_PER_DIE				1
+#define	PLANES_PER_LUN				2		//plane of a block is its block number modulo the plane count
 
 #define	MAIN_BLOCKS_PER_DIE			(MAIN_BLOCKS_PER_LUN * LUNS_PER_DIE)
 #define TOTAL_BLOCKS_PER_DIE		(TOTAL_BLOCKS_PER_LUN * LUNS_PER_DIE)
@@ -202,6 +203,23 @@
 #define	USER_BLOCKS_PER_LUN		2048		//user configurable factor
 #define	USER_CHANNELS		(NUMBER_OF_CONNECTED_CHANNEL)		//user configurable factor
 #define	USER_WAYS				2//8			//user configurable factor
+#define	EXTENT_FORWARD_MAP		0		//user configurable factor, 1: translate sequentially written regions by extents, the flat forward map is kept for demoted regions
+#define	SECTOR_VALID_TRACKING	1		//user configurable factor, 1: skip read-modify-write when the rest of a slice was never written
+#define	REVERSE_MAP_IN_SPARE	0		//user configurable factor, 1: drop virtualSliceMap, reverse mapping is read from the LSA tag in the spare region
+#define	READ_AHEAD				1		//user configurable factor, 1: prefetch the following slices of sequential read streams into the data buffer
+#define	BACKGROUND_WRITE_BACK	1		//user configurable factor, 1: clean dirty data buffer entries near the eviction end while the host is idle
+#define	DATA_BUF_PARTITION		0		//user configurable factor, 1: guarantee each NVMe IO submission queue a quota of data buffer entries
+#define	DATA_BUF_ENTRIES_PER_DIE_MAX	512		//user configurable factor, cap of the data buffer entries sized from the memory map at boot
+#define	READ_HIT_FAST_PATH		1		//user configurable factor, 1: serve reads that fully hit idle data buffer entries with direct host DMA
+#define	DEADLINE_SCHEDULING		1		//user configurable factor, 1: issue NAND requests of a channel in order of their class deadline instead of by operation type
+#define	NAND_READ_BYPASS		1		//user configurable factor, 1: let a queued read overtake the programs and erases ahead of it on an idle way
+#define	NAND_SUSPEND_RESUME		0		//user configurable factor, 1: suspend a running program or erase for the reads queued behind it (issued through the suspend and resume hooks of the NAND driver)
+#define	NAND_COMPLETION_EVENT	1		//user configurable factor, 1: visit only the channels with new requests or completion signals from the NAND storage controller
+#define	MULTI_PLANE_OPERATION	0		//user configurable factor, 1: pair open blocks across planes and fuse queued same-page requests into multi-plane operations (fused operations are issued through the multi-plane hooks of the NAND driver)
+#define	NAND_CACHE_OPERATION	0		//user configurable factor, 1: overlap the data transfer of the next queued page with the array time of the current one by cache program and cache read (issued through the cache hooks of the NAND driver)
+#define	CHANNEL_ACTIVITY_MASK	1		//user configurable factor, 1: skip the channels whose ways have neither queued nor running requests
+#define	NVME_WRR_ARBITRATION	1		//user configurable factor, 1: take IO commands from the submission queues by urgent priority and weighted round robin, 0: in the order they were fetched
+#define	DUAL_CORE_FTL			0		//user configurable factor, 1: run the FTL and NAND scheduling on the second core, the first core keeps the NVMe host interface
 //************************************************************************
 
 #define	BYTES_PER_DATA_REGION_OF_SLICE		16384		//slice is a mapping unit of FTL
@@ -104,7 +104,7 @@ void InitGcVictimMap()
 // ----------------------------- Main GC routine -------------------------------
 void GarbageCollection(unsigned int dieNo)
 {
-    unsigned int victimBlockNo, pageNo, virtualSliceAddr, logicalSliceAddr, dieNoForGcCopy, reqSlotTag;
+    unsigned int victimBlockNo, pageNo, virtualSliceAddr, dieNoForGcCopy, reqSlotTag, copyReadReqSlotTag;
 
     // [CAT-CHG][정책 캡슐화] 희생 블록 선택 정책은 GetFromGcVictimList 내부로 숨김.
     //  - Greedy: "가장 큰 invalid 버킷의 head pop"을 내부에서 수행
@@ -114,62 +114,63 @@ void GarbageCollection(unsigned int dieNo)
     dieNoForGcCopy = dieNo;
 
     // [COMMON] 선택된 victim 블록이 모두 invalid가 아니면(valid가 있으면) 유효 데이터 이주 수행
-    if (virtualBlockMapPtr->block[dieNo][victimBlockNo].invalidSliceCnt != SLICES_PER_BLOCK)
+    if (virtualBlockMapPtr->invalidSliceCnt[dieNo][victimBlockNo] != SLICES_PER_BLOCK)
     {
         for (pageNo = 0; pageNo < USER_PAGES_PER_BLOCK; pageNo++)
         {
             virtualSliceAddr = Vorg2VsaTranslation(dieNo, victimBlockNo, pageNo);
-            logicalSliceAddr = virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr;
 
             // [COMMON] valid 여부 확인 (논리→가상 양방향 매핑의 일치성)
-            if (logicalSliceAddr != LSA_NONE)
-                if (logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr == virtualSliceAddr) // valid data
-                {
-                    // ---------------------------- READ ----------------------------
-                    // [COMMON] 읽기 요청 구성 및 디스패치(진짜 하드웨어에서 수행되도록 전달하는 것) (변화 없음)
-                    reqSlotTag = GetFromFreeReqQ();
-                    reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
-                    reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
-                    reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
-                    reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
-                    UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
-                    reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
-                    SelectLowLevelReqQ(reqSlotTag);
-
-                    // ---------------------------- WRITE ---------------------------
-                    // [COMMON] 쓰기 요청 구성 및 디스패치(진짜 하드웨어에서 수행되도록 전달하는 것) (변화 없음)
-                    reqSlotTag = GetFromFreeReqQ();
-
-                    reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
-                    reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_WRITE;
-                    reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
-                    reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
-                    UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
-                    
-                    // [COMMON] GC 대상 다이에서 새 가상 슬라이스 할당 (변화 없음)
-                    reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = FindFreeVirtualSliceForGc(dieNoForGcCopy, victimBlockNo);
-
-                    // [COMMON] 매핑 갱신 (논리→가상 / 가상→논리) (변화 없음)
-                    logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr;
-                    virtualSliceMapPtr->virtualSlice[reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr].logicalSliceAddr = logicalSliceAddr;
-                    SelectLowLevelReqQ(reqSlotTag);
-                }
+            if (CheckValidVirtualSlice(virtualSliceAddr)) // valid data
+            {
+                // ---------------------------- READ ----------------------------
+                // [COMMON] 읽기 요청 구성 및 디스패치(진짜 하드웨어에서 수행되도록 전달하는 것) (변화 없음)
+                reqSlotTag = GetFromFreeReqQ();
+                reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+                reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
+                reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = LSA_NONE;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
+                reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
+                UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
+                reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
+                copyReadReqSlotTag = reqSlotTag;
+
+                // ---------------------------- WRITE ---------------------------
+                // [COMMON] 쓰기 요청 구성 및 디스패치(진짜 하드웨어에서 수행되도록 전달하는 것) (변화 없음)
+                reqSlotTag = GetFromFreeReqQ();
+
+                reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+                reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_WRITE;
+                reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = LSA_NONE;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
+                reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
+                UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
+                
+                // [COMMON] GC 대상 다이에서 새 가상 슬라이스 할당 (변화 없음)
+                reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = FindFreeVirtualSliceForGc(dieNoForGcCopy, victimBlockNo);
+
+                // [COMMON] 매핑 갱신 (논리→가상 / 가상→논리) (변화 없음)
+                UpdateMapForGcCopy(copyReadReqSlotTag, reqSlotTag);
+
+                //the read is issued once the write is chained behind it, so that its completion finds the write to map
+                SelectLowLevelReqQ(copyReadReqSlotTag);
+                SelectLowLevelReqQ(reqSlotTag);
+            }
         }
     }
 
     EraseBlock(dieNo, victimBlockNo);
+    SyncReleaseGcCopy();
 
     // [CAT] Victim block was reset by erase; record current tick as last invalid tick baseline.
     gcLastInvalidTick[dieNo][victimBlockNo] = gcActivityTick;
@@ -182,8 +183,8 @@ void GarbageCollection(unsigned int dieNo)
 static inline void DetachBlockFromGcList(unsigned int dieNo, unsigned int blockNo)
 {
     SelectiveGetFromGcVictimList(dieNo, blockNo);
-    virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
-    virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = BLOCK_NONE;
+    virtualBlockMapPtr->nextBlock[dieNo][blockNo] = BLOCK_NONE;
+    virtualBlockMapPtr->prevBlock[dieNo][blockNo] = BLOCK_NONE;
 }
 
 
@@ -201,15 +202,15 @@ void PutToGcVictimList(unsigned int dieNo, unsigned int blockNo, unsigned int in
 
     if (gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock != BLOCK_NONE)
     {
-        virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock;
-        virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
-        virtualBlockMapPtr->block[dieNo][gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock].nextBlock = blockNo;
+        virtualBlockMapPtr->prevBlock[dieNo][blockNo] = gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock;
+        virtualBlockMapPtr->nextBlock[dieNo][blockNo] = BLOCK_NONE;
+        virtualBlockMapPtr->nextBlock[dieNo][gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock] = blockNo;
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = blockNo;
     }
     else
     {
-        virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = BLOCK_NONE;
-        virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
+        virtualBlockMapPtr->prevBlock[dieNo][blockNo] = BLOCK_NONE;
+        virtualBlockMapPtr->nextBlock[dieNo][blockNo] = BLOCK_NONE;
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock = blockNo;
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = blockNo;
     }
@@ -231,7 +232,7 @@ unsigned int GetFromGcVictimList(unsigned int dieNo)
         unsigned int blockNo = gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock;
         while (blockNo != BLOCK_NONE) {
             // 순회 중 구조 변화 대비: next를 먼저 백업
-            unsigned int nextBlock = virtualBlockMapPtr->block[dieNo][blockNo].nextBlock;
+            unsigned int nextBlock = virtualBlockMapPtr->nextBlock[dieNo][blockNo];
 
             uint32_t score = CalculateCatScore(dieNo, blockNo);
             if (score > bestScore) {
@@ -259,10 +260,10 @@ unsigned int GetFromGcVictimList(unsigned int dieNo)
 //  - add +1 guards to avoid zero-division & favor decisive differences
 static inline uint32_t CalculateCatScore(unsigned int dieNo, unsigned int blockNo)
 {
-    unsigned int invalidSlices = virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt;
+    unsigned int invalidSlices = virtualBlockMapPtr->invalidSliceCnt[dieNo][blockNo];
     unsigned int validSlices   = USER_PAGES_PER_BLOCK - invalidSlices;
     unsigned int ageTicks      = gcActivityTick - gcLastInvalidTick[dieNo][blockNo];
-    unsigned int wearCount     = virtualBlockMapPtr->block[dieNo][blockNo].eraseCnt;
+    unsigned int wearCount     = virtualBlockMapPtr->eraseCnt[dieNo][blockNo];
 
     uint64_t numerator   = (uint64_t)(invalidSlices + 1) * (uint64_t)(ageTicks + 1);
     uint64_t denominator = (uint64_t)(validSlices   + 1) * (uint64_t)(wearCount + 1);
@@ -279,23 +280,23 @@ void SelectiveGetFromGcVictimList(unsigned int dieNo, unsigned int blockNo)
 {
     unsigned int nextBlock, prevBlock, invalidSliceCnt;
 
-    nextBlock = virtualBlockMapPtr->block[dieNo][blockNo].nextBlock;       // 현재 블록의 다음 노드
-    prevBlock = virtualBlockMapPtr->block[dieNo][blockNo].prevBlock;       // 현재 블록의 이전 노드
-    invalidSliceCnt = virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt; // 블록이 속한 버킷 인덱스 (무효 슬라이스 수)
+    nextBlock = virtualBlockMapPtr->nextBlock[dieNo][blockNo];       // 현재 블록의 다음 노드
+    prevBlock = virtualBlockMapPtr->prevBlock[dieNo][blockNo];       // 현재 블록의 이전 노드
+    invalidSliceCnt = virtualBlockMapPtr->invalidSliceCnt[dieNo][blockNo]; // 블록이 속한 버킷 인덱스 (무효 슬라이스 수)
 
     if ((nextBlock != BLOCK_NONE) && (prevBlock != BLOCK_NONE))            // ① 중간 노드일 경우 (prev도 있고 next도 있음)
     {
-        virtualBlockMapPtr->block[dieNo][prevBlock].nextBlock = nextBlock; // prev → next 연결
-        virtualBlockMapPtr->block[dieNo][nextBlock].prevBlock = prevBlock; // next → prev 연결
+        virtualBlockMapPtr->nextBlock[dieNo][prevBlock] = nextBlock; // prev → next 연결
+        virtualBlockMapPtr->prevBlock[dieNo][nextBlock] = prevBlock; // next → prev 연결
     }
     else if ((nextBlock == BLOCK_NONE) && (prevBlock != BLOCK_NONE))       // ② tail 노드 (뒤 노드 없음, 앞 노드만 있음)
     {
-        virtualBlockMapPtr->block[dieNo][prevBlock].nextBlock = BLOCK_NONE; // prev가 새 tail 이므로 nextBlock = NONE
+        virtualBlockMapPtr->nextBlock[dieNo][prevBlock] = BLOCK_NONE; // prev가 새 tail 이므로 nextBlock = NONE
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = prevBlock; // tail 갱신
     }
     else if ((nextBlock != BLOCK_NONE) && (prevBlock == BLOCK_NONE))       // ③ head 노드 (앞 노드 없음, 뒤 노드만 있음)
     {
-        virtualBlockMapPtr->block[dieNo][nextBlock].prevBlock = BLOCK_NONE; // next가 새 head, prevBlock = NONE
+        virtualBlockMapPtr->prevBlock[dieNo][nextBlock] = BLOCK_NONE; // next가 새 head, prevBlock = NONE
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock = nextBlock; // head 갱신
     }
     else                                                                   // ④ 단독 노드 (prev, next 둘 다 없음 ⇒ 리스트 크기=1)
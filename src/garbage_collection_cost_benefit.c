@@ -108,63 +108,62 @@ void InitGcVictimMap()
 // ----------------------------- Main GC routine -------------------------------
 void GarbageCollection(unsigned int dieNo)
 {
-    unsigned int victimBlockNo, pageNo, virtualSliceAddr, logicalSliceAddr, dieNoForGcCopy, reqSlotTag;
+    unsigned int victimBlockNo, pageNo, virtualSliceAddr, dieNoForGcCopy, reqSlotTag, copyReadReqSlotTag;
 
     // [Policy] Victim selection is inside GetFromGcVictimList (name preserved)
     victimBlockNo = GetFromGcVictimList(dieNo);
     dieNoForGcCopy = dieNo;
 
-    if (virtualBlockMapPtr->block[dieNo][victimBlockNo].invalidSliceCnt != SLICES_PER_BLOCK)
+    if (virtualBlockMapPtr->invalidSliceCnt[dieNo][victimBlockNo] != SLICES_PER_BLOCK)
     {
         for (pageNo = 0; pageNo < USER_PAGES_PER_BLOCK; pageNo++)
         {
             virtualSliceAddr = Vorg2VsaTranslation(dieNo, victimBlockNo, pageNo);
-            logicalSliceAddr = virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr;
-
-            if (logicalSliceAddr != LSA_NONE)
-                if (logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr == virtualSliceAddr) // valid data
-                {
-                    // ---------------------------- READ ----------------------------
-                    reqSlotTag = GetFromFreeReqQ();
-                    reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
-                    reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
-                    reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
-                    reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
-                    UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
-                    reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
-
-                    SelectLowLevelReqQ(reqSlotTag);
-
-                    // ---------------------------- WRITE ---------------------------
-                    reqSlotTag = GetFromFreeReqQ();
-                    reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
-                    reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_WRITE;
-                    reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
-                    reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
-                    reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
-                    UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
-                    reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = FindFreeVirtualSliceForGc(dieNoForGcCopy, victimBlockNo);
-
-                    logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr;
-                    virtualSliceMapPtr->virtualSlice[reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr].logicalSliceAddr = logicalSliceAddr;
-                    
-                    SelectLowLevelReqQ(reqSlotTag);
-                }
+
+            if (CheckValidVirtualSlice(virtualSliceAddr)) // valid data
+            {
+                // ---------------------------- READ ----------------------------
+                reqSlotTag = GetFromFreeReqQ();
+                reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+                reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
+                reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = LSA_NONE;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
+                reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
+                UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
+                reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
+                copyReadReqSlotTag = reqSlotTag;
+
+                // ---------------------------- WRITE ---------------------------
+                reqSlotTag = GetFromFreeReqQ();
+                reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+                reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_WRITE;
+                reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = LSA_NONE;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+                reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
+                reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
+                UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
+                reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = FindFreeVirtualSliceForGc(dieNoForGcCopy, victimBlockNo);
+
+                UpdateMapForGcCopy(copyReadReqSlotTag, reqSlotTag);
+
+                //the read is issued once the write is chained behind it, so that its completion finds the write to map
+                SelectLowLevelReqQ(copyReadReqSlotTag);
+                SelectLowLevelReqQ(reqSlotTag);
+            }
         }
     }
 
     EraseBlock(dieNo, victimBlockNo);
+    SyncReleaseGcCopy();
 
     // [CB에서 추가한 라인] Victim block was reset by erase; record current tick as its new birth time.
     // erase 직후에 gcLastEraseTick을 현재 tick으로 설정하면 그 블록의 age가 0이 되어 점수가 낮아지고, 
@@ -184,8 +183,8 @@ void GarbageCollection(unsigned int dieNo)
 static inline void DetachBlockFromGcList(unsigned int dieNo, unsigned int blockNo)
 {
     SelectiveGetFromGcVictimList(dieNo, blockNo);
-    virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
-    virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = BLOCK_NONE;
+    virtualBlockMapPtr->nextBlock[dieNo][blockNo] = BLOCK_NONE;
+    virtualBlockMapPtr->prevBlock[dieNo][blockNo] = BLOCK_NONE;
 }
 
 // --------------------------- Cost-Benefit Scoring ----------------------------
@@ -194,7 +193,7 @@ static inline void DetachBlockFromGcList(unsigned int dieNo, unsigned int blockN
 //  - add +1 guards to avoid zero-division & favor decisive differences
 static inline uint32_t CalculateCostBenefitScore(unsigned int dieNo, unsigned int blockNo)
 {
-    unsigned int invalidSlices = virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt;
+    unsigned int invalidSlices = virtualBlockMapPtr->invalidSliceCnt[dieNo][blockNo];
     unsigned int validSlices   = USER_PAGES_PER_BLOCK - invalidSlices;
     unsigned int ageTicks      = gcActivityTick - gcLastEraseTick[dieNo][blockNo];
     uint64_t benefit           = (uint64_t)invalidSlices * (uint64_t)(ageTicks + 1) * (uint64_t)USER_PAGES_PER_BLOCK;
@@ -219,15 +218,15 @@ void PutToGcVictimList(unsigned int dieNo, unsigned int blockNo, unsigned int in
 
     if (gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock != BLOCK_NONE)
     {
-        virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock;
-        virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
-        virtualBlockMapPtr->block[dieNo][gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock].nextBlock = blockNo;
+        virtualBlockMapPtr->prevBlock[dieNo][blockNo] = gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock;
+        virtualBlockMapPtr->nextBlock[dieNo][blockNo] = BLOCK_NONE;
+        virtualBlockMapPtr->nextBlock[dieNo][gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock] = blockNo;
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = blockNo;
     }
     else
     {
-        virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = BLOCK_NONE;
-        virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
+        virtualBlockMapPtr->prevBlock[dieNo][blockNo] = BLOCK_NONE;
+        virtualBlockMapPtr->nextBlock[dieNo][blockNo] = BLOCK_NONE;
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock = blockNo;
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = blockNo;
     }
@@ -251,7 +250,7 @@ unsigned int GetFromGcVictimList(unsigned int dieNo)
         unsigned int blockNo = gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock;
         while (blockNo != BLOCK_NONE)
         {
-            unsigned int nextBlock = virtualBlockMapPtr->block[dieNo][blockNo].nextBlock; // save next before scoring
+            unsigned int nextBlock = virtualBlockMapPtr->nextBlock[dieNo][blockNo]; // save next before scoring
             uint32_t score = CalculateCostBenefitScore(dieNo, blockNo);
             if (score > bestScore)
             {
@@ -279,23 +278,23 @@ void SelectiveGetFromGcVictimList(unsigned int dieNo, unsigned int blockNo)
 {
     unsigned int nextBlock, prevBlock, invalidSliceCnt;
 
-    nextBlock = virtualBlockMapPtr->block[dieNo][blockNo].nextBlock;
-    prevBlock = virtualBlockMapPtr->block[dieNo][blockNo].prevBlock;
-    invalidSliceCnt = virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt;
+    nextBlock = virtualBlockMapPtr->nextBlock[dieNo][blockNo];
+    prevBlock = virtualBlockMapPtr->prevBlock[dieNo][blockNo];
+    invalidSliceCnt = virtualBlockMapPtr->invalidSliceCnt[dieNo][blockNo];
 
     if ((nextBlock != BLOCK_NONE) && (prevBlock != BLOCK_NONE))
     {
-        virtualBlockMapPtr->block[dieNo][prevBlock].nextBlock = nextBlock;
-        virtualBlockMapPtr->block[dieNo][nextBlock].prevBlock = prevBlock;
+        virtualBlockMapPtr->nextBlock[dieNo][prevBlock] = nextBlock;
+        virtualBlockMapPtr->prevBlock[dieNo][nextBlock] = prevBlock;
     }
     else if ((nextBlock == BLOCK_NONE) && (prevBlock != BLOCK_NONE))
     {
-        virtualBlockMapPtr->block[dieNo][prevBlock].nextBlock = BLOCK_NONE;
+        virtualBlockMapPtr->nextBlock[dieNo][prevBlock] = BLOCK_NONE;
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = prevBlock;
     }
     else if ((nextBlock != BLOCK_NONE) && (prevBlock == BLOCK_NONE))
     {
-        virtualBlockMapPtr->block[dieNo][nextBlock].prevBlock = BLOCK_NONE;
+        virtualBlockMapPtr->prevBlock[dieNo][nextBlock] = BLOCK_NONE;
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock = nextBlock;
     }
     else
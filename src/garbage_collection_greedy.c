@@ -71,71 +71,70 @@ void InitGcVictimMap()
 // ----------------------------- Main GC routine -------------------------------
 void GarbageCollection(unsigned int dieNo)
 {
-	unsigned int victimBlockNo, pageNo, virtualSliceAddr, logicalSliceAddr, dieNoForGcCopy, reqSlotTag;
+	unsigned int victimBlockNo, pageNo, virtualSliceAddr, dieNoForGcCopy, reqSlotTag, copyReadReqSlotTag;
 
 	victimBlockNo = GetFromGcVictimList(dieNo);
 	dieNoForGcCopy = dieNo;
 
 	// [COMMON] 선택된 victim 블록이 모두 invalid가 아니면(valid가 있으면) 유효 데이터 이주 수행
-	if(virtualBlockMapPtr->block[dieNo][victimBlockNo].invalidSliceCnt != SLICES_PER_BLOCK)
+	if(virtualBlockMapPtr->invalidSliceCnt[dieNo][victimBlockNo] != SLICES_PER_BLOCK)
 	{
 		for(pageNo=0 ; pageNo<USER_PAGES_PER_BLOCK ; pageNo++)
 		{
 			virtualSliceAddr = Vorg2VsaTranslation(dieNo, victimBlockNo, pageNo);
-			logicalSliceAddr = virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr;
 
 			// [COMMON] valid 여부 확인 (논리→가상 양방향 매핑의 일치성)
-			if(logicalSliceAddr != LSA_NONE)
-				if(logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr ==  virtualSliceAddr) //valid data
-				{
-					// ---------------------------- READ ----------------------------
-					// [COMMON] 읽기 요청 구성 및 디스패치(진짜 하드웨어에서 수행되도록 전달하는 것)
-					reqSlotTag = GetFromFreeReqQ();
-
-					reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
-					reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
-					reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
-					reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
-					UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
-					reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
-
-					SelectLowLevelReqQ(reqSlotTag);
-
-					// ---------------------------- WRITE ---------------------------
-					// [COMMON] 쓰기 요청 구성 및 디스패치 (진짜 하드웨어에서 수행되도록 전달하는 것)
-					reqSlotTag = GetFromFreeReqQ();
-
-					reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
-					reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_WRITE;
-					reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
-					reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
-					UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
-					
-					// [COMMON] GC 대상 다이에서 새 가상 슬라이스 할당
-					reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = FindFreeVirtualSliceForGc(dieNoForGcCopy, victimBlockNo);
-
-					// [COMMON] 매핑 갱신 (논리→가상 / 가상→논리)
-					logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr;
-					virtualSliceMapPtr->virtualSlice[reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr].logicalSliceAddr = logicalSliceAddr;
-
-					SelectLowLevelReqQ(reqSlotTag);
-				}
+			if(CheckValidVirtualSlice(virtualSliceAddr)) //valid data
+			{
+				// ---------------------------- READ ----------------------------
+				// [COMMON] 읽기 요청 구성 및 디스패치(진짜 하드웨어에서 수행되도록 전달하는 것)
+				reqSlotTag = GetFromFreeReqQ();
+
+				reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+				reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
+				reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = LSA_NONE;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
+				reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
+				UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
+				reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
+				copyReadReqSlotTag = reqSlotTag;
+
+				// ---------------------------- WRITE ---------------------------
+				// [COMMON] 쓰기 요청 구성 및 디스패치 (진짜 하드웨어에서 수행되도록 전달하는 것)
+				reqSlotTag = GetFromFreeReqQ();
+
+				reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+				reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_WRITE;
+				reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = LSA_NONE;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
+				reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = AllocateTempDataBuf(dieNo);
+				UpdateTempDataBufEntryInfoBlockingReq(reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry, reqSlotTag);
+				
+				// [COMMON] GC 대상 다이에서 새 가상 슬라이스 할당
+				reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = FindFreeVirtualSliceForGc(dieNoForGcCopy, victimBlockNo);
+
+				// [COMMON] 매핑 갱신 (논리→가상 / 가상→논리)
+				UpdateMapForGcCopy(copyReadReqSlotTag, reqSlotTag);
+
+				//the read is issued once the write is chained behind it, so that its completion finds the write to map
+				SelectLowLevelReqQ(copyReadReqSlotTag);
+				SelectLowLevelReqQ(reqSlotTag);
+			}
 		}
 	}
 
 	EraseBlock(dieNo, victimBlockNo);
+	SyncReleaseGcCopy();
 }
 
 // 버킷(무효 슬라이스 개수 invalidSliceCnt)의 양단 연결 리스트에 그냥 넣기만 함.
@@ -145,15 +144,15 @@ void PutToGcVictimList(unsigned int dieNo, unsigned int blockNo, unsigned int in
 {
 	if(gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock != BLOCK_NONE)
 	{
-		virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock;
-		virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
-		virtualBlockMapPtr->block[dieNo][gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock].nextBlock = blockNo;
+		virtualBlockMapPtr->prevBlock[dieNo][blockNo] = gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock;
+		virtualBlockMapPtr->nextBlock[dieNo][blockNo] = BLOCK_NONE;
+		virtualBlockMapPtr->nextBlock[dieNo][gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock] = blockNo;
 		gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = blockNo;
 	}
 	else
 	{
-		virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = BLOCK_NONE;
-		virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
+		virtualBlockMapPtr->prevBlock[dieNo][blockNo] = BLOCK_NONE;
+		virtualBlockMapPtr->nextBlock[dieNo][blockNo] = BLOCK_NONE;
 		gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock = blockNo;
 		gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = blockNo;
 	}
@@ -174,11 +173,11 @@ unsigned int GetFromGcVictimList(unsigned int dieNo)
             evictedBlockNo = gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock;
 
             // head pop: 다음 노드를 새 head로, 없으면 head/tail 모두 NONE
-            if (virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock != BLOCK_NONE) {
-                virtualBlockMapPtr->block[dieNo]
-                    [virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock].prevBlock = BLOCK_NONE;
+            if (virtualBlockMapPtr->nextBlock[dieNo][evictedBlockNo] != BLOCK_NONE) {
+                virtualBlockMapPtr->prevBlock[dieNo]
+                    [virtualBlockMapPtr->nextBlock[dieNo][evictedBlockNo]] = BLOCK_NONE;
                 gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock =
-                    virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock;
+                    virtualBlockMapPtr->nextBlock[dieNo][evictedBlockNo];
             } else {
                 gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock = BLOCK_NONE;
                 gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = BLOCK_NONE;
@@ -196,23 +195,23 @@ void SelectiveGetFromGcVictimList(unsigned int dieNo, unsigned int blockNo)
 {
     unsigned int nextBlock, prevBlock, invalidSliceCnt;
 
-    nextBlock = virtualBlockMapPtr->block[dieNo][blockNo].nextBlock;       // 현재 블록의 다음 노드
-    prevBlock = virtualBlockMapPtr->block[dieNo][blockNo].prevBlock;       // 현재 블록의 이전 노드
-    invalidSliceCnt = virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt; // 블록이 속한 버킷 인덱스 (무효 슬라이스 수)
+    nextBlock = virtualBlockMapPtr->nextBlock[dieNo][blockNo];       // 현재 블록의 다음 노드
+    prevBlock = virtualBlockMapPtr->prevBlock[dieNo][blockNo];       // 현재 블록의 이전 노드
+    invalidSliceCnt = virtualBlockMapPtr->invalidSliceCnt[dieNo][blockNo]; // 블록이 속한 버킷 인덱스 (무효 슬라이스 수)
 
     if ((nextBlock != BLOCK_NONE) && (prevBlock != BLOCK_NONE))            // ① 중간 노드일 경우 (prev도 있고 next도 있음)
     {
-        virtualBlockMapPtr->block[dieNo][prevBlock].nextBlock = nextBlock; // prev → next 연결
-        virtualBlockMapPtr->block[dieNo][nextBlock].prevBlock = prevBlock; // next → prev 연결
+        virtualBlockMapPtr->nextBlock[dieNo][prevBlock] = nextBlock; // prev → next 연결
+        virtualBlockMapPtr->prevBlock[dieNo][nextBlock] = prevBlock; // next → prev 연결
     }
     else if ((nextBlock == BLOCK_NONE) && (prevBlock != BLOCK_NONE))       // ② tail 노드 (뒤 노드 없음, 앞 노드만 있음)
     {
-        virtualBlockMapPtr->block[dieNo][prevBlock].nextBlock = BLOCK_NONE; // prev가 새 tail 이므로 nextBlock = NONE
+        virtualBlockMapPtr->nextBlock[dieNo][prevBlock] = BLOCK_NONE; // prev가 새 tail 이므로 nextBlock = NONE
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock = prevBlock; // tail 갱신
     }
     else if ((nextBlock != BLOCK_NONE) && (prevBlock == BLOCK_NONE))       // ③ head 노드 (앞 노드 없음, 뒤 노드만 있음)
     {
-        virtualBlockMapPtr->block[dieNo][nextBlock].prevBlock = BLOCK_NONE; // next가 새 head, prevBlock = NONE
+        virtualBlockMapPtr->prevBlock[dieNo][nextBlock] = BLOCK_NONE; // next가 새 head, prevBlock = NONE
         gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock = nextBlock; // head 갱신
     }
     else                                                                   // ④ 단독 노드 (prev, next 둘 다 없음 ⇒ 리스트 크기=1)
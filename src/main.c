@@ -73,9 +73,71 @@
 #include "nvme/nvme_main.h"
 #include "nvme/host_lld.h"
 
+#include "ftl_config.h"
+#include "core_ring.h"
+
+#if (DUAL_CORE_FTL)
+//both cores keep the FTL metadata coherent through the snoop control unit, so it has to be shareable
+#define CACHED_SECTION_ATTR		0x10C1E
+#else
+#define CACHED_SECTION_ATTR		0xC1E
+#endif
+
 
 XScuGic GicInstance;
 
+#if (DUAL_CORE_FTL)
+#define CPU1_START_ADDR_REG		0xFFFFFFF0		//the boot ROM of CPU1 jumps to this address on an event
+#define FTL_CORE_STACK_BYTES	0x10000
+#define STRINGIFY(x)			#x
+#define TO_STRING(x)			STRINGIFY(x)
+
+extern u32 MMUTable;
+
+unsigned int ftlCoreStack[FTL_CORE_STACK_BYTES / sizeof(unsigned int)] __attribute__((aligned(8)));
+
+static void EnableCoreCoherency()
+{
+	unsigned int actlr;
+
+	//SMP bit joins the core to the coherency domain, FW bit broadcasts its cache and TLB maintenance
+	__asm__ __volatile__("mrc p15, 0, %0, c1, c0, 1" : "=r"(actlr));
+	actlr |= (1 << 6) | (1 << 0);
+	__asm__ __volatile__("mcr p15, 0, %0, c1, c0, 1" : : "r"(actlr));
+}
+
+void ftl_core_init()
+{
+	EnableCoreCoherency();
+
+	//share the page table of the host interface core, inner and outer write-back, shareable walks
+	__asm__ __volatile__("mcr p15, 0, %0, c3, c0, 0" : : "r"(0xFFFFFFFF));
+	__asm__ __volatile__("mcr p15, 0, %0, c2, c0, 0" : : "r"((unsigned int)&MMUTable | 0x5B));
+	__asm__ __volatile__("mcr p15, 0, %0, c8, c7, 0" : : "r"(0));
+	__asm__ __volatile__("dsb\n\tisb");
+
+	Xil_EnableMMU();
+	//L2 is shared and already enabled by the host interface core
+	Xil_L1ICacheEnable();
+	Xil_L1DCacheEnable();
+
+	ftl_core_main();
+}
+
+static void __attribute__((naked)) ftl_core_entry()
+{
+	__asm__ __volatile__(
+			"ldr sp, =ftlCoreStack + " TO_STRING(FTL_CORE_STACK_BYTES) "\n\t"
+			"b ftl_core_init\n\t");
+}
+
+static void StartFtlCore()
+{
+	*(volatile unsigned int *)CPU1_START_ADDR_REG = (unsigned int)ftl_core_entry;
+	__asm__ __volatile__("dsb\n\tsev");
+}
+#endif
+
 int main()
 {
 	unsigned int u;
@@ -86,16 +148,20 @@ int main()
 	Xil_DCacheDisable();
 	Xil_DisableMMU();
 
+#if (DUAL_CORE_FTL)
+	EnableCoreCoherency();
+#endif
+
 	// Paging table set
 	#define MB (1024*1024)
 	for (u = 0; u < 4096; u++)
 	{
 		if (u < 0x2)
-			Xil_SetTlbAttributes(u * MB, 0xC1E); // cached & buffered
+			Xil_SetTlbAttributes(u * MB, CACHED_SECTION_ATTR); // cached & buffered
 		else if (u < 0x180)
 			Xil_SetTlbAttributes(u * MB, 0xC12); // uncached & nonbuffered
 		else if (u < 0x400)
-			Xil_SetTlbAttributes(u * MB, 0xC1E); // cached & buffered
+			Xil_SetTlbAttributes(u * MB, CACHED_SECTION_ATTR); // cached & buffered
 		else
 			Xil_SetTlbAttributes(u * MB, 0xC12); // uncached & nonbuffered
 	}
@@ -129,6 +195,11 @@ int main()
 
 	dev_irq_init();
 
+#if (DUAL_CORE_FTL)
+	InitCoreRing();
+	StartFtlCore();
+#endif
+
 	nvme_main();
 
 	xil_printf("done\r\n");
@@ -53,6 +53,7 @@
 #include "request_schedule.h"
 #include "request_transform.h"
 #include "garbage_collection.h"
+#include "core_ring.h"
 
 #define DRAM_START_ADDR					0x00100000
 
@@ -64,17 +65,20 @@
 
 #define RESERVED0_START_ADDR			0x00300000
 #define RESERVED0_END_ADDR				0x0FFFFFFF
+// Uncached, shared by both cores
+//for inter-core rings
+#define CORE_RING_MAP_ADDR				RESERVED0_START_ADDR
 
 #define FTL_MANAGEMENT_START_ADDR		0x10000000
 // Uncached & Unbuffered
 //for data buffer
 #define DATA_BUFFER_BASE_ADDR 					0x10000000
-#define TEMPORARY_DATA_BUFFER_BASE_ADDR			(DATA_BUFFER_BASE_ADDR + AVAILABLE_DATA_BUFFER_ENTRY_COUNT * BYTES_PER_DATA_REGION_OF_SLICE)
+#define TEMPORARY_DATA_BUFFER_BASE_ADDR			(DATA_BUFFER_BASE_ADDR + MAX_DATA_BUFFER_ENTRY_COUNT * BYTES_PER_DATA_REGION_OF_SLICE)
 #define SPARE_DATA_BUFFER_BASE_ADDR				(TEMPORARY_DATA_BUFFER_BASE_ADDR + AVAILABLE_TEMPORARY_DATA_BUFFER_ENTRY_COUNT * BYTES_PER_DATA_REGION_OF_SLICE)
-#define TEMPORARY_SPARE_DATA_BUFFER_BASE_ADDR	(SPARE_DATA_BUFFER_BASE_ADDR + AVAILABLE_DATA_BUFFER_ENTRY_COUNT * BYTES_PER_SPARE_REGION_OF_SLICE)
+#define TEMPORARY_SPARE_DATA_BUFFER_BASE_ADDR	(SPARE_DATA_BUFFER_BASE_ADDR + MAX_DATA_BUFFER_ENTRY_COUNT * BYTES_PER_SPARE_REGION_OF_SLICE)
 #define RESERVED_DATA_BUFFER_BASE_ADDR 			(TEMPORARY_SPARE_DATA_BUFFER_BASE_ADDR + AVAILABLE_TEMPORARY_DATA_BUFFER_ENTRY_COUNT * BYTES_PER_SPARE_REGION_OF_SLICE)
 //for nand request completion
-#define COMPLETE_FLAG_TABLE_ADDR			0x17000000
+#define COMPLETE_FLAG_TABLE_ADDR			(DATA_BUFFER_BASE_ADDR + DATA_BUFFER_REGION_BYTES)
 #define STATUS_REPORT_TABLE_ADDR			(COMPLETE_FLAG_TABLE_ADDR + sizeof(COMPLETE_FLAG_TABLE))
 #define ERROR_INFO_TABLE_ADDR				(STATUS_REPORT_TABLE_ADDR + sizeof(STATUS_REPORT_TABLE))
 #define TEMPORARY_PAY_LOAD_ADDR				(ERROR_INFO_TABLE_ADDR+ sizeof(ERROR_INFO_TABLE))
@@ -85,8 +89,19 @@
 #define TEMPORARY_DATA_BUFFER_MAP_ADDR 		(DATA_BUFFFER_HASH_TABLE_ADDR + sizeof(DATA_BUF_HASH_TABLE))
 // for map tables
 #define LOGICAL_SLICE_MAP_ADDR				(TEMPORARY_DATA_BUFFER_MAP_ADDR + sizeof(TEMPORARY_DATA_BUF_MAP))
-#define VIRTUAL_SLICE_MAP_ADDR				(LOGICAL_SLICE_MAP_ADDR + sizeof(LOGICAL_SLICE_MAP))
+#if (EXTENT_FORWARD_MAP)
+#define EXTENT_MAP_ADDR						(LOGICAL_SLICE_MAP_ADDR + sizeof(LOGICAL_SLICE_MAP))
+#define SECTOR_VALID_MAP_ADDR				(EXTENT_MAP_ADDR + sizeof(EXTENT_MAP))
+#else
+#define SECTOR_VALID_MAP_ADDR				(LOGICAL_SLICE_MAP_ADDR + sizeof(LOGICAL_SLICE_MAP))
+#endif
+#if (REVERSE_MAP_IN_SPARE)
+#define VALID_SLICE_BITMAP_ADDR				(SECTOR_VALID_MAP_ADDR + sizeof(SECTOR_VALID_MAP))
+#define VIRTUAL_BLOCK_MAP_ADDR				(VALID_SLICE_BITMAP_ADDR + sizeof(VALID_SLICE_BITMAP))
+#else
+#define VIRTUAL_SLICE_MAP_ADDR				(SECTOR_VALID_MAP_ADDR + sizeof(SECTOR_VALID_MAP))
 #define VIRTUAL_BLOCK_MAP_ADDR				(VIRTUAL_SLICE_MAP_ADDR + sizeof(VIRTUAL_SLICE_MAP))
+#endif
 #define PHY_BLOCK_MAP_ADDR					(VIRTUAL_BLOCK_MAP_ADDR + sizeof(VIRTUAL_BLOCK_MAP))
 #define BAD_BLOCK_TABLE_INFO_MAP_ADDR		(PHY_BLOCK_MAP_ADDR + sizeof(PHY_BLOCK_MAP))
 #define VIRTUAL_DIE_MAP_ADDR				(BAD_BLOCK_TABLE_INFO_MAP_ADDR + sizeof(BAD_BLOCK_TABLE_INFO_MAP))
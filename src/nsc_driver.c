@@ -51,6 +51,8 @@
 #include "xparameters.h"
 #include <assert.h>
 
+V2F_EXT_OPS v2fExtOps = { 0 };
+
 typedef struct
 {
 	unsigned char delayVal[32];
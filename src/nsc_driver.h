@@ -112,6 +112,7 @@
 #define V2FRequestReportDone(statusReport) ((statusReport) & 1)
 #define V2FEliminateReportDoneFlag(statusReport) ((statusReport) >> 1)
 #define V2FRequestComplete(statusReport) (((statusReport) & 0x60) == 0x60)
+#define V2FRequestCacheReady(statusReport) (((statusReport) & 0x40) == 0x40)
 #define V2FRequestFail(statusReport) ((statusReport) & 3)
 
 typedef struct
@@ -445,5 +446,22 @@ void V2FReadIdAsync(T4REGS* t4regs, int way, unsigned int* statusReport, unsigne
 void V2FReadIdSync(T4REGS* t4regs, int way, unsigned int* statusReport);
 unsigned int V2FReadyBusyAsync(T4REGS* t4regs);
 
+//operations the stock NSC microcode has no routine for, the scheduler issues them only through these hooks
+//a hook left at 0 keeps the scheduler on the plain operations, a port with the routines or a host test stub installs them before InitFTL
+typedef struct
+{
+	void (*suspendAsync)(T4REGS* t4regs, int way);		//suspend the running program or erase, the way reports ready once it is suspended
+	void (*resumeAsync)(T4REGS* t4regs, int way);		//resume it, the way reports its completion as usual
+	void (*readPageTriggerMultiPlaneAsync)(T4REGS* t4regs, int way, unsigned int rowAddress0, unsigned int rowAddress1);		//read the same page of two planes into their page registers
+	void (*programPageMultiPlaneAsync)(T4REGS* t4regs, int way, unsigned int rowAddress0, void* pageDataBuffer0, void* spareDataBuffer0,
+			unsigned int rowAddress1, void* pageDataBuffer1, void* spareDataBuffer1);		//program the same page of two planes, one status for both
+	void (*programPageCacheAsync)(T4REGS* t4regs, int way, unsigned int rowAddress, void* pageDataBuffer, void* spareDataBuffer);		//the way reports cache ready once the page left the cache register
+	void (*readPageTransferCacheAsync)(T4REGS* t4regs, int way, void* pageDataBuffer, void* spareDataBuffer, unsigned int* errorInformation, unsigned int* completion,
+			unsigned int rowAddress, unsigned int nextRowAddress);		//transfer the page from the cache register while the array reads the next row
+	void (*readCacheEndAsync)(T4REGS* t4regs, int way);		//move the last page read by the array to the cache register and leave the cache read mode
+} V2F_EXT_OPS;
+
+extern V2F_EXT_OPS v2fExtOps;
+
 
 #endif /* FMC_DRIVER_H_ */
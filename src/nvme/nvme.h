@@ -54,6 +54,12 @@
 #define MAX_NUM_OF_IO_SQ	8
 #define MAX_NUM_OF_IO_CQ	8
 
+#define SQ_PRIO_URGENT		0
+#define SQ_PRIO_HIGH		1
+#define SQ_PRIO_MEDIUM		2
+#define SQ_PRIO_LOW			3
+#define SQ_PRIO_COUNT		4
+
 #define ADMIN_CMD_DRAM_DATA_BUFFER		0x00200000
 
 #define STORAGE_CAPACITY_L				0x00000000	// not used
@@ -78,6 +84,7 @@
 #define ADMIN_DOORBELL_BUFFER_CONFIG						0x7C
 #define ADMIN_SECURITY_SEND									0x81
 #define ADMIN_SECURITY_RECEIVE								0x82
+#define ADMIN_VENDOR_PIN_LBA_RANGE							0xC0
 
 /*Opcodes for IO Commands */
 #define IO_NVM_FLUSH										0x00
@@ -320,6 +327,20 @@ typedef struct _ADMIN_SET_FEATURES_NUMBER_OF_QUEUES_DW11
 	};
 } ADMIN_SET_FEATURES_NUMBER_OF_QUEUES_DW11;
 
+typedef struct _ADMIN_SET_FEATURES_ARBITRATION_DW11
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned char AB				:3;
+			unsigned char reserved0			:5;
+			unsigned char LPW;
+			unsigned char MPW;
+			unsigned char HPW;
+		};
+	};
+} ADMIN_SET_FEATURES_ARBITRATION_DW11;
+
 
 /* Get Features Command */
 typedef struct _ADMIN_GET_FEATURES_DW10
@@ -438,6 +459,19 @@ typedef struct _ADMIN_GET_LOG_PAGE_DW10
 	};
 } ADMIN_GET_LOG_PAGE_DW10;
 
+/* Vendor Specific Pin LBA Range Command, dword10 and dword11 hold the starting LBA */
+typedef struct _ADMIN_VENDOR_PIN_LBA_RANGE_DW12
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned short NLB;
+			unsigned short reserved0		:15;
+			unsigned short UNPIN			:1;
+		};
+	};
+} ADMIN_VENDOR_PIN_LBA_RANGE_DW12;
+
 /* Identify - Power State Descriptor Data Structure */
 typedef struct _ADMIN_IDENTIFY_POWER_STATE_DESCRIPTOR
 {
@@ -815,6 +849,7 @@ typedef struct _NVME_IO_SQ_STATUS
 	unsigned short qSzie;
 	unsigned int pcieBaseAddrL;
 	unsigned int pcieBaseAddrH;
+	unsigned int qPrio;
 } NVME_IO_SQ_STATUS;
 
 typedef struct _NVME_IO_CQ_STATUS
@@ -835,6 +870,7 @@ typedef struct _NVME_STATUS
 	NVME_ADMIN_QUEUE_STATUS adminQueueInfo;
 	unsigned short numOfIOSubmissionQueuesAllocated;//non zero-based value
 	unsigned short numOfIOCompletionQueuesAllocated;//non zero-based value
+	unsigned int arbitration;//arbitration feature, dword11 of the last set features
 	NVME_IO_SQ_STATUS ioSqInfo[MAX_NUM_OF_IO_SQ];
 	NVME_IO_CQ_STATUS ioCqInfo[MAX_NUM_OF_IO_CQ];
 } NVME_CONTEXT;
@@ -55,6 +55,11 @@
 #include "host_lld.h" // Host low-level driver
 #include "nvme_identify.h" // NVMe identify command handling
 #include "nvme_admin_cmd.h" // NVMe admin command declarations
+#include "nvme_arbitration.h" // IO submission queue arbiter
+
+#include "../ftl_config.h"
+#include "../request_transform.h"
+#include "../core_ring.h"
 
 // External global NVMe task context
 extern NVME_CONTEXT g_nvmeTask;
@@ -115,6 +120,8 @@ void handle_set_features(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
         }
         case ARBITRATION:
         {
+            g_nvmeTask.arbitration = nvmeAdminCmd->dword11; // Keep the raw value for get features
+            SetNvmeArbFeature(nvmeAdminCmd->dword11); // Apply arbitration burst and class weights
             nvmeCPL->dword[0] = 0x0; // Indicate success
             nvmeCPL->specific = 0x0; // No specific data
             break;
@@ -188,6 +195,12 @@ void handle_get_features(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 			nvmeCPL->specific = g_nvmeTask.cacheEn;
 			break;
 		}
+		case ARBITRATION:
+		{
+			nvmeCPL->dword[0] = 0x0;
+			nvmeCPL->specific = g_nvmeTask.arbitration;
+			break;
+		}
 		case POWER_MANAGEMENT:
 		{
 			nvmeCPL->dword[0] = 0x0;
@@ -240,6 +253,7 @@ void handle_create_io_sq(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 	ioSqStatus->valid = 1;
 	ioSqStatus->qSzie = sqInfo10.QSIZE;
 	ioSqStatus->cqVector = sqInfo11.CQID;
+	ioSqStatus->qPrio = sqInfo11.QPRIO;
 	ioSqStatus->pcieBaseAddrL = nvmeAdminCmd->PRP1[0];
 	ioSqStatus->pcieBaseAddrH = nvmeAdminCmd->PRP1[1];
 
@@ -263,11 +277,14 @@ void handle_delete_io_sq(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 	ioSqIdx = (unsigned int)sqInfo10.QID - 1;
 	ioSqStatus = g_nvmeTask.ioSqInfo + ioSqIdx;
 
+	AbortNvmeArbSq(ioSqIdx); // Commands fetched from the queue but not dispatched yet are aborted
+
 	ioSqStatus->valid = 0;
 	ioSqStatus->cqVector = 0;
 	ioSqStatus->qSzie = 0;
 	ioSqStatus->pcieBaseAddrL = 0;
 	ioSqStatus->pcieBaseAddrH = 0;
+	ioSqStatus->qPrio = 0;
 
 	set_io_sq(ioSqIdx, 0, 0, 0, 0, 0);
 
@@ -414,6 +431,47 @@ void handle_get_log_page(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 	nvmeCPL->specific = 0x9;//invalid log page
 }
 
+void handle_vendor_pin_lba_range(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
+{
+	ADMIN_VENDOR_PIN_LBA_RANGE_DW12 pinInfo;
+	NVME_COMPLETION cpl;
+	unsigned int startLba, startLsa, endLsa, report;
+
+	pinInfo.dword = nvmeAdminCmd->dword12;
+	startLba = nvmeAdminCmd->dword10;
+
+	cpl.dword[0] = 0x0;
+	if((nvmeAdminCmd->dword11 != 0) || (startLba + pinInfo.NLB >= storageCapacity_L))
+	{
+		cpl.statusField.SC = SC_LBA_OUT_OF_RANGE;
+		nvmeCPL->dword[0] = cpl.dword[0];
+		nvmeCPL->specific = 0x0;
+		return ;
+	}
+
+	//partially covered slices are pinned as a whole
+	startLsa = startLba / NVME_BLOCKS_PER_SLICE;
+	endLsa = (startLba + pinInfo.NLB) / NVME_BLOCKS_PER_SLICE + 1;
+
+#if (DUAL_CORE_FTL)
+	//the data buffer belongs to the FTL core
+	report = RequestFtlCore(pinInfo.UNPIN ? FTL_CORE_REQ_UNPIN : FTL_CORE_REQ_PIN, startLsa, endLsa - startLsa);
+#else
+	if(pinInfo.UNPIN)
+		report = UnpinDataBufRange(startLsa, endLsa - startLsa);
+	else
+		report = PinDataBufRange(startLsa, endLsa - startLsa);
+#endif
+
+	if(report == PIN_REPORT_FAIL)
+		cpl.statusField.SC = SC_CAPACITY_EXCEEDED;
+
+	//xil_printf("%s LSA %d ~ %d: %s\r\n", pinInfo.UNPIN ? "Unpin" : "Pin", startLsa, endLsa - 1, (report == PIN_REPORT_DONE) ? "done" : "pin limit exceeded");
+
+	nvmeCPL->dword[0] = cpl.dword[0];
+	nvmeCPL->specific = 0x0;
+}
+
 void handle_nvme_admin_cmd(NVME_COMMAND *nvmeCmd)
 {	NVME_ADMIN_COMMAND *nvmeAdminCmd;
 	NVME_COMPLETION nvmeCPL;
@@ -508,6 +566,11 @@ void handle_nvme_admin_cmd(NVME_COMMAND *nvmeCmd)
 			nvmeCPL.specific = 0x0;
 			break;
 		}
+		case ADMIN_VENDOR_PIN_LBA_RANGE:
+		{
+			handle_vendor_pin_lba_range(nvmeAdminCmd, &nvmeCPL);
+			break;
+		}
 		default:
 		{
 			xil_printf("Not Support Admin Command OPC: %X\r\n", opc);
@@ -66,6 +66,8 @@ void handle_identify(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
 
 void handle_get_log_page(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL);
 
+void handle_vendor_pin_lba_range(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL);
+
 void handle_nvme_admin_cmd(NVME_COMMAND *nvmeCmd);
 
 #endif	//__NVME_ADMIN_CMD_H_
@@ -0,0 +1,294 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_arbitration.c for Cosmos+ OpenSSD
+// Copyright (c) 2016 Hanyang University ENC Lab.
+// Contributed by Yong Ho Song <yhsong@enc.hanyang.ac.kr>
+//				  Youngjin Jo <yjjo@enc.hanyang.ac.kr>
+//				  Sangjin Lee <sjlee@enc.hanyang.ac.kr>
+//				  Jaewook Kwak <jwkwak@enc.hanyang.ac.kr>
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Company: ENC Lab. <http://enc.hanyang.ac.kr>
+// Engineer: Sangjin Lee <sjlee@enc.hanyang.ac.kr>
+//			 Jaewook Kwak <jwkwak@enc.hanyang.ac.kr>
+//
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe Submission Queue Arbiter
+// File Name: nvme_arbitration.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - hold fetched IO commands per submission queue
+//   - select the next IO command by the NVMe weighted round robin with urgent priority class arbitration
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#include "xil_printf.h"
+#include "debug.h"
+
+#include "nvme.h"
+#include "nvme_arbitration.h"
+#include "../ftl_config.h"
+
+extern NVME_CONTEXT g_nvmeTask;
+
+ARB_CONTEXT arbCtx;
+
+void InitNvmeArb()
+{
+	unsigned int entry, sqIdx, prio;
+
+	for(entry = 0; entry < ARB_PENDING_CMD_COUNT; entry++)
+		arbCtx.cmdEntry[entry].nextEntry = entry + 1;
+	arbCtx.cmdEntry[ARB_PENDING_CMD_COUNT - 1].nextEntry = ARB_CMD_NONE;
+	arbCtx.freeHead = 0;
+	arbCtx.pendingCmdCnt = 0;
+
+	for(sqIdx = 0; sqIdx < MAX_NUM_OF_IO_SQ; sqIdx++)
+	{
+		arbCtx.sq[sqIdx].headEntry = ARB_CMD_NONE;
+		arbCtx.sq[sqIdx].tailEntry = ARB_CMD_NONE;
+		arbCtx.sq[sqIdx].pendingCmdCnt = 0;
+	}
+
+	for(prio = 0; prio < SQ_PRIO_COUNT; prio++)
+	{
+		arbCtx.prioPendingCmdCnt[prio] = 0;
+		arbCtx.rrSqIdx[prio] = MAX_NUM_OF_IO_SQ - 1;
+	}
+
+	arbCtx.curSqIdx = 0;
+	arbCtx.curBurstLeft = 0;
+
+	//the arbitration feature returns to its default on controller reset
+	g_nvmeTask.arbitration = 0;
+	SetNvmeArbFeature(0);
+}
+
+void SetNvmeArbFeature(unsigned int dword11)
+{
+	ADMIN_SET_FEATURES_ARBITRATION_DW11 arbInfo11;
+	unsigned int prio;
+
+	arbInfo11.dword = dword11;
+
+	//arbitration burst is 2^AB commands, weights are zero-based
+	if(arbInfo11.AB == ARB_BURST_UNLIMITED)
+		arbCtx.burst = ARB_PENDING_CMD_COUNT;
+	else
+		arbCtx.burst = 1 << arbInfo11.AB;
+
+	arbCtx.weight[SQ_PRIO_URGENT] = 0;
+	arbCtx.weight[SQ_PRIO_HIGH] = arbInfo11.HPW + 1;
+	arbCtx.weight[SQ_PRIO_MEDIUM] = arbInfo11.MPW + 1;
+	arbCtx.weight[SQ_PRIO_LOW] = arbInfo11.LPW + 1;
+
+	for(prio = 0; prio < SQ_PRIO_COUNT; prio++)
+		arbCtx.credit[prio] = arbCtx.weight[prio];
+
+	arbCtx.curBurstLeft = 0;
+}
+
+void PutToNvmeArbQ(NVME_COMMAND *nvmeCmd)
+{
+	unsigned int entry, sqIdx, dwordIdx;
+
+	ASSERT(0 < nvmeCmd->qID && nvmeCmd->qID <= MAX_NUM_OF_IO_SQ);
+	ASSERT(arbCtx.freeHead != ARB_CMD_NONE);
+
+	entry = arbCtx.freeHead;
+	arbCtx.freeHead = arbCtx.cmdEntry[entry].nextEntry;
+
+	arbCtx.cmdEntry[entry].nvmeCmd.qID = nvmeCmd->qID;
+	arbCtx.cmdEntry[entry].nvmeCmd.cmdSlotTag = nvmeCmd->cmdSlotTag;
+	arbCtx.cmdEntry[entry].nvmeCmd.cmdSeqNum = nvmeCmd->cmdSeqNum;
+	for(dwordIdx = 0; dwordIdx < 16; dwordIdx++)
+		arbCtx.cmdEntry[entry].nvmeCmd.cmdDword[dwordIdx] = nvmeCmd->cmdDword[dwordIdx];
+	arbCtx.cmdEntry[entry].nextEntry = ARB_CMD_NONE;
+	arbCtx.cmdEntry[entry].prio = g_nvmeTask.ioSqInfo[nvmeCmd->qID - 1].qPrio;
+
+#if (NVME_WRR_ARBITRATION)
+	sqIdx = nvmeCmd->qID - 1;
+#else
+	sqIdx = 0;	//without arbitration every IO command waits in one queue in the order it was fetched
+#endif
+	if(arbCtx.sq[sqIdx].tailEntry != ARB_CMD_NONE)
+		arbCtx.cmdEntry[arbCtx.sq[sqIdx].tailEntry].nextEntry = entry;
+	else
+		arbCtx.sq[sqIdx].headEntry = entry;
+	arbCtx.sq[sqIdx].tailEntry = entry;
+
+	arbCtx.sq[sqIdx].pendingCmdCnt++;
+	arbCtx.prioPendingCmdCnt[arbCtx.cmdEntry[entry].prio]++;
+	arbCtx.pendingCmdCnt++;
+}
+
+//unlink the entry following prevEntry in the queue, the counters are kept by the class stored at fetch time
+static void RemoveFromNvmeArbQ(unsigned int sqIdx, unsigned int prevEntry, unsigned int entry)
+{
+	if(prevEntry == ARB_CMD_NONE)
+		arbCtx.sq[sqIdx].headEntry = arbCtx.cmdEntry[entry].nextEntry;
+	else
+		arbCtx.cmdEntry[prevEntry].nextEntry = arbCtx.cmdEntry[entry].nextEntry;
+	if(arbCtx.sq[sqIdx].tailEntry == entry)
+		arbCtx.sq[sqIdx].tailEntry = prevEntry;
+
+	arbCtx.sq[sqIdx].pendingCmdCnt--;
+	arbCtx.prioPendingCmdCnt[arbCtx.cmdEntry[entry].prio]--;
+	arbCtx.pendingCmdCnt--;
+
+	arbCtx.cmdEntry[entry].nextEntry = arbCtx.freeHead;
+	arbCtx.freeHead = entry;
+}
+
+#if (NVME_WRR_ARBITRATION)
+static unsigned int SelectNvmeArbSqOfPrio(unsigned int prio)
+{
+	unsigned int sqIdx, loop;
+
+	sqIdx = arbCtx.rrSqIdx[prio];
+	for(loop = 0; loop < MAX_NUM_OF_IO_SQ; loop++)
+	{
+		sqIdx = (sqIdx + 1) % MAX_NUM_OF_IO_SQ;
+		if(arbCtx.sq[sqIdx].pendingCmdCnt && (arbCtx.cmdEntry[arbCtx.sq[sqIdx].headEntry].prio == prio))
+		{
+			arbCtx.rrSqIdx[prio] = sqIdx;
+			return sqIdx;
+		}
+	}
+
+	xil_printf("No pending command in priority class: %d\r\n", prio);
+	ASSERT(0);
+	return 0;
+}
+
+static unsigned int SelectNvmeArbSq()
+{
+	unsigned int prio;
+
+	//urgent queues are served strictly before the weighted round robin classes
+	if(arbCtx.prioPendingCmdCnt[SQ_PRIO_URGENT])
+		return SelectNvmeArbSqOfPrio(SQ_PRIO_URGENT);
+
+	while(1)
+	{
+		for(prio = SQ_PRIO_HIGH; prio <= SQ_PRIO_LOW; prio++)
+			if(arbCtx.prioPendingCmdCnt[prio] && arbCtx.credit[prio])
+				return SelectNvmeArbSqOfPrio(prio);
+
+		//every class holding commands used up its weight, start a new round
+		for(prio = SQ_PRIO_HIGH; prio <= SQ_PRIO_LOW; prio++)
+			arbCtx.credit[prio] = arbCtx.weight[prio];
+	}
+}
+#endif
+
+unsigned int GetFromNvmeArbQ(NVME_COMMAND *nvmeCmd)
+{
+	unsigned int entry, sqIdx, dwordIdx;
+#if (NVME_WRR_ARBITRATION)
+	unsigned int prio;
+#endif
+
+	if(arbCtx.pendingCmdCnt == 0)
+		return 0;
+
+#if (NVME_WRR_ARBITRATION)
+	//keep taking from the current queue until its burst ends, an urgent command preempts the turn
+	sqIdx = arbCtx.curSqIdx;
+	if((arbCtx.curBurstLeft == 0) || (arbCtx.sq[sqIdx].pendingCmdCnt == 0) ||
+			((arbCtx.cmdEntry[arbCtx.sq[sqIdx].headEntry].prio != SQ_PRIO_URGENT) && arbCtx.prioPendingCmdCnt[SQ_PRIO_URGENT]))
+	{
+		sqIdx = SelectNvmeArbSq();
+		arbCtx.curSqIdx = sqIdx;
+		arbCtx.curBurstLeft = arbCtx.burst;
+	}
+#else
+	sqIdx = 0;
+#endif
+
+	entry = arbCtx.sq[sqIdx].headEntry;
+	nvmeCmd->qID = arbCtx.cmdEntry[entry].nvmeCmd.qID;
+	nvmeCmd->cmdSlotTag = arbCtx.cmdEntry[entry].nvmeCmd.cmdSlotTag;
+	nvmeCmd->cmdSeqNum = arbCtx.cmdEntry[entry].nvmeCmd.cmdSeqNum;
+	for(dwordIdx = 0; dwordIdx < 16; dwordIdx++)
+		nvmeCmd->cmdDword[dwordIdx] = arbCtx.cmdEntry[entry].nvmeCmd.cmdDword[dwordIdx];
+
+#if (NVME_WRR_ARBITRATION)
+	prio = arbCtx.cmdEntry[entry].prio;
+	arbCtx.curBurstLeft--;
+	if(prio != SQ_PRIO_URGENT)
+	{
+		arbCtx.credit[prio]--;
+		if(arbCtx.credit[prio] == 0)
+			arbCtx.curBurstLeft = 0;
+	}
+#endif
+
+	RemoveFromNvmeArbQ(sqIdx, ARB_CMD_NONE, entry);
+	return 1;
+}
+
+//complete a fetched IO command of a deleted submission queue without executing it
+void AbortNvmeArbCmd(NVME_COMMAND *nvmeCmd)
+{
+	NVME_COMPLETION nvmeCPL;
+
+	nvmeCPL.dword[0] = 0;
+	nvmeCPL.specific = 0x0;
+	nvmeCPL.statusField.SCT = SCT_GENERIC_COMMAND_STATUS;
+	nvmeCPL.statusField.SC = SC_COMMAND_ABORTED_DUE_TO_SQ_DELETION;
+	set_auto_nvme_cpl(nvmeCmd->cmdSlotTag, nvmeCPL.specific, nvmeCPL.statusFieldWord);
+}
+
+//abort the commands still waiting for a submission queue being deleted
+void AbortNvmeArbSq(unsigned int sqIdx)
+{
+	unsigned int arbSqIdx, prevEntry, entry, nextEntry;
+
+#if (NVME_WRR_ARBITRATION)
+	arbSqIdx = sqIdx;
+#else
+	arbSqIdx = 0;
+#endif
+
+	prevEntry = ARB_CMD_NONE;
+	entry = arbCtx.sq[arbSqIdx].headEntry;
+	while(entry != ARB_CMD_NONE)
+	{
+		nextEntry = arbCtx.cmdEntry[entry].nextEntry;
+		if(arbCtx.cmdEntry[entry].nvmeCmd.qID == sqIdx + 1)
+		{
+			AbortNvmeArbCmd(&arbCtx.cmdEntry[entry].nvmeCmd);
+			RemoveFromNvmeArbQ(arbSqIdx, prevEntry, entry);
+		}
+		else
+			prevEntry = entry;
+		entry = nextEntry;
+	}
+}
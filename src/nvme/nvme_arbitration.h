@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_arbitration.h for Cosmos+ OpenSSD
+// Copyright (c) 2016 Hanyang University ENC Lab.
+// Contributed by Yong Ho Song <yhsong@enc.hanyang.ac.kr>
+//				  Youngjin Jo <yjjo@enc.hanyang.ac.kr>
+//				  Sangjin Lee <sjlee@enc.hanyang.ac.kr>
+//				  Jaewook Kwak <jwkwak@enc.hanyang.ac.kr>
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Company: ENC Lab. <http://enc.hanyang.ac.kr>
+// Engineer: Sangjin Lee <sjlee@enc.hanyang.ac.kr>
+//			 Jaewook Kwak <jwkwak@enc.hanyang.ac.kr>
+//
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe Submission Queue Arbiter
+// File Name: nvme_arbitration.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define data structure and functions of the IO submission queue arbiter
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __NVME_ARBITRATION_H_
+#define __NVME_ARBITRATION_H_
+
+#include "nvme.h"
+#include "host_lld.h"
+
+#define ARB_PENDING_CMD_COUNT		(1 << P_SLOT_TAG_WIDTH)		//one entry per command slot of the controller, a fetched IO command always finds an entry
+#define ARB_CMD_NONE				0xFFFF
+
+#define ARB_BURST_UNLIMITED			7
+
+typedef struct _ARB_CMD_ENTRY
+{
+	NVME_COMMAND nvmeCmd;
+	unsigned short nextEntry;
+	unsigned short prio;			//class of the queue when the command was fetched, the queue may be deleted or recreated meanwhile
+} ARB_CMD_ENTRY;
+
+typedef struct _ARB_SQ_ENTRY
+{
+	unsigned short headEntry;
+	unsigned short tailEntry;
+	unsigned int pendingCmdCnt;
+} ARB_SQ_ENTRY;
+
+typedef struct _ARB_CONTEXT
+{
+	ARB_CMD_ENTRY cmdEntry[ARB_PENDING_CMD_COUNT];
+	ARB_SQ_ENTRY sq[MAX_NUM_OF_IO_SQ];
+	unsigned int freeHead;
+	unsigned int pendingCmdCnt;
+	unsigned int prioPendingCmdCnt[SQ_PRIO_COUNT];
+
+	unsigned int burst;							//commands taken from one queue per turn, ARB_PENDING_CMD_COUNT when unlimited
+	unsigned int weight[SQ_PRIO_COUNT];			//commands of a class per weighted round robin round, urgent has no weight
+	unsigned int credit[SQ_PRIO_COUNT];
+	unsigned int rrSqIdx[SQ_PRIO_COUNT];		//round robin position among the queues of each class
+
+	unsigned int curSqIdx;
+	unsigned int curBurstLeft;
+} ARB_CONTEXT;
+
+void InitNvmeArb();
+void SetNvmeArbFeature(unsigned int dword11);
+void PutToNvmeArbQ(NVME_COMMAND *nvmeCmd);
+unsigned int GetFromNvmeArbQ(NVME_COMMAND *nvmeCmd);
+void AbortNvmeArbCmd(NVME_COMMAND *nvmeCmd);
+void AbortNvmeArbSq(unsigned int sqIdx);
+
+#endif	//__NVME_ARBITRATION_H_
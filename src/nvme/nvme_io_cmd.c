@@ -60,8 +60,9 @@
 
 #include "../ftl_config.h"
 #include "../request_transform.h"
+#include "../core_ring.h"
 
-void handle_nvme_io_read(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+void handle_nvme_io_read(unsigned int cmdSlotTag, unsigned int qID, NVME_IO_COMMAND *nvmeIOCmd)
 {
 	IO_READ_COMMAND_DW12 readInfo12;
 	//IO_READ_COMMAND_DW13 readInfo13;
@@ -82,11 +83,11 @@ void handle_nvme_io_read(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
 	ASSERT((nvmeIOCmd->PRP1[0] & 0x3) == 0 && (nvmeIOCmd->PRP2[0] & 0x3) == 0); //error
 	ASSERT(nvmeIOCmd->PRP1[1] < 0x10000 && nvmeIOCmd->PRP2[1] < 0x10000);
 
-	ReqTransNvmeToSlice(cmdSlotTag, startLba[0], nlb, IO_NVM_READ);
+	ReqTransNvmeToSlice(cmdSlotTag, qID, startLba[0], nlb, IO_NVM_READ);
 }
 
 
-void handle_nvme_io_write(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+void handle_nvme_io_write(unsigned int cmdSlotTag, unsigned int qID, NVME_IO_COMMAND *nvmeIOCmd)
 {
 	IO_READ_COMMAND_DW12 writeInfo12;
 	//IO_READ_COMMAND_DW13 writeInfo13;
@@ -110,13 +111,15 @@ void handle_nvme_io_write(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
 	ASSERT((nvmeIOCmd->PRP1[0] & 0xF) == 0 && (nvmeIOCmd->PRP2[0] & 0xF) == 0);
 	ASSERT(nvmeIOCmd->PRP1[1] < 0x10000 && nvmeIOCmd->PRP2[1] < 0x10000);
 
-	ReqTransNvmeToSlice(cmdSlotTag, startLba[0], nlb, IO_NVM_WRITE);
+	ReqTransNvmeToSlice(cmdSlotTag, qID, startLba[0], nlb, IO_NVM_WRITE);
 }
 
 void handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
 {
 	NVME_IO_COMMAND *nvmeIOCmd;
+#if (!DUAL_CORE_FTL)
 	NVME_COMPLETION nvmeCPL;
+#endif
 	unsigned int opc;
 	nvmeIOCmd = (NVME_IO_COMMAND*)nvmeCmd->cmdDword;
 	/*		xil_printf("OPC = 0x%X\r\n", nvmeIOCmd->OPC);
@@ -132,24 +135,43 @@ void handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
 	switch(opc)
 	{
 		case IO_NVM_FLUSH:
+		{
+			//pinned entries are never evicted, so flush is the point where they become durable
+			FlushPinnedDataBuf();
+
+#if (DUAL_CORE_FTL)
+			//the completion is posted by the host interface core
+			PutToCoreSlotRing(&coreRingMapPtr->cplRing, nvmeCmd->cmdSlotTag);
+#else
+			nvmeCPL.dword[0] = 0;
+			nvmeCPL.specific = 0x0;
+			set_auto_nvme_cpl(nvmeCmd->cmdSlotTag, nvmeCPL.specific, nvmeCPL.statusFieldWord);
+#endif
+			break;
+		}
 		case IO_NVM_WRITE_ZERO:
 		{
 		//	xil_printf("IO Flush Command\r\n");
+#if (DUAL_CORE_FTL)
+			//the completion is posted by the host interface core
+			PutToCoreSlotRing(&coreRingMapPtr->cplRing, nvmeCmd->cmdSlotTag);
+#else
 			nvmeCPL.dword[0] = 0;
 			nvmeCPL.specific = 0x0;
 			set_auto_nvme_cpl(nvmeCmd->cmdSlotTag, nvmeCPL.specific, nvmeCPL.statusFieldWord);
+#endif
 			break;
 		}
 		case IO_NVM_WRITE:
 		{
 //			xil_printf("IO Write Command\r\n");
-			handle_nvme_io_write(nvmeCmd->cmdSlotTag, nvmeIOCmd);
+			handle_nvme_io_write(nvmeCmd->cmdSlotTag, nvmeCmd->qID, nvmeIOCmd);
 			break;
 		}
 		case IO_NVM_READ:
 		{
 //			xil_printf("IO Read Command\r\n");
-			handle_nvme_io_read(nvmeCmd->cmdSlotTag, nvmeIOCmd);
+			handle_nvme_io_read(nvmeCmd->cmdSlotTag, nvmeCmd->qID, nvmeIOCmd);
 			break;
 		}
 		default:
@@ -161,3 +183,20 @@ void handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
 	}
 }
 
+unsigned int get_nvme_io_cmd_slice_cnt(NVME_COMMAND *nvmeCmd)
+{
+	NVME_IO_COMMAND *nvmeIOCmd;
+	IO_READ_COMMAND_DW12 rwInfo12;
+	unsigned int startLba;
+
+	nvmeIOCmd = (NVME_IO_COMMAND*)nvmeCmd->cmdDword;
+
+	//only reads and writes are transformed into slice requests
+	if((nvmeIOCmd->OPC != IO_NVM_READ) && (nvmeIOCmd->OPC != IO_NVM_WRITE))
+		return 0;
+
+	rwInfo12.dword = nvmeIOCmd->dword[12];
+	startLba = nvmeIOCmd->dword[10];
+
+	return ((startLba % NVME_BLOCKS_PER_SLICE) + rwInfo12.NLB) / NVME_BLOCKS_PER_SLICE + 1;
+}
@@ -48,5 +48,6 @@
 #define __NVME_IO_CMD_H_
 
 void handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd);
+unsigned int get_nvme_io_cmd_slice_cnt(NVME_COMMAND *nvmeCmd);
 
 #endif	//__NVME_IO_CMD_H_
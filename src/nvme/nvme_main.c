@@ -65,29 +65,68 @@
 #include "nvme_main.h" // NVMe main function declaration
 #include "nvme_admin_cmd.h" // NVMe admin command handling
 #include "nvme_io_cmd.h" // NVMe IO command handling
+#include "nvme_arbitration.h" // IO submission queue arbiter
 
 #include "../memory_map.h" // Memory map definitions
 
 // Global NVMe task context
 volatile NVME_CONTEXT g_nvmeTask;
 
+// Pass an IO command to the FTL, on the FTL core when the FTL runs there
+// Returns 0 without passing it when the FTL cannot take it yet
+static unsigned int DispatchNvmeIoCmd(NVME_COMMAND *nvmeCmd)
+{
+#if (DUAL_CORE_FTL)
+    // The FTL core admits the command, a full ring holds it here
+    if(IsCoreCmdRingFull(&coreRingMapPtr->ioCmdRing))
+        return 0;
+
+    PutToCoreCmdRing(&coreRingMapPtr->ioCmdRing, nvmeCmd);
+#else
+    unsigned int sliceCnt;
+
+    // The command is held until request slots and buffer entries can be reserved for it
+    sliceCnt = get_nvme_io_cmd_slice_cnt(nvmeCmd);
+    if(AdmitNvmeIoCmd(sliceCnt) != ADMISSION_REPORT_DONE)
+        return 0;
+
+    handle_nvme_io_cmd(nvmeCmd); // Handle IO command - read/write, flush, TRIM, etc.
+    ReqTransSliceToLowLevel(); // Request translation to low-level
+    ReleaseNvmeIoCmdAdmission(sliceCnt); // The requests are allocated now
+#endif
+
+    return 1;
+}
+
 // Main NVMe function
 void nvme_main()
 {
+#if (!DUAL_CORE_FTL)
     unsigned int exeLlr; // Flag to execute low-level requests
+#endif
     unsigned int rstCnt = 0; // Reset counter
+    NVME_COMMAND ioCmd; // IO command waiting for admission
+    unsigned int ioCmdHeld = 0; // Flag of the held IO command
 
     xil_printf("!!! Wait until FTL reset complete !!! \r\n");	//xilinx console print
 
     // Initialize the Flash Translation Layer (FTL)
     InitFTL();
+    InitNvmeArb();
+
+#if (DUAL_CORE_FTL)
+    // Hand the initialized FTL over to the FTL core
+    coreRingMapPtr->ftlCoreState = FTL_CORE_STATE_RUN;
+#endif
 
     xil_printf("\r\nFTL reset complete!!! \r\n");	//xilinx console print
     xil_printf("Turn on the host PC \r\n");			//xilinx console print
 
     while(1) // Infinite loop to handle NVMe tasks
     {
+#if (!DUAL_CORE_FTL)
         exeLlr = 1; // Default to execute low-level requests
+#endif
 
         // Check NVMe task status
         if(g_nvmeTask.status == NVME_TASK_WAIT_CC_EN)
@@ -97,6 +136,8 @@ void nvme_main()
             if(ccEn == 1)	// If enabled
             {
                 set_nvme_admin_queue(1, 1, 1); // Initialize admin queue
+                InitNvmeArb(); // Drop commands held from before the reset
+                ioCmdHeld = 0;
                 set_nvme_csts_rdy(1); // Set controller ready status
                 g_nvmeTask.status = NVME_TASK_RUNNING; // Update task status
                 xil_printf("\r\nNVMe ready!!!\r\n");
@@ -106,20 +147,40 @@ void nvme_main()
         {
             NVME_COMMAND nvmeCmd; // NVMe command structure
             unsigned int cmdValid;
-            cmdValid = get_nvme_cmd(&nvmeCmd.qID, &nvmeCmd.cmdSlotTag, &nvmeCmd.cmdSeqNum, nvmeCmd.cmdDword); // Fetch NVMe command
-            if(cmdValid == 1)
+
+            // Drain the command FIFO so that admin commands are served and every submission queue with pending work takes part in arbitration
+            // The arbiter has an entry per command slot, so fetching goes on while an IO command waits for admission
+            while(1)
             {
+                cmdValid = get_nvme_cmd(&nvmeCmd.qID, &nvmeCmd.cmdSlotTag, &nvmeCmd.cmdSeqNum, nvmeCmd.cmdDword); // Fetch NVMe command
+                if(cmdValid != 1)
+                    break;
+
                 rstCnt = 0; // Reset the counter
                 if(nvmeCmd.qID == 0)
                 {
-                    handle_nvme_admin_cmd(&nvmeCmd); // Handle admin command - identify, set/get features, etc.
+                    handle_nvme_admin_cmd(&nvmeCmd); // Admin commands are not arbitrated
+
+                    // The held command is aborted as well when its submission queue was deleted
+                    if(ioCmdHeld && !g_nvmeTask.ioSqInfo[ioCmd.qID - 1].valid)
+                    {
+                        AbortNvmeArbCmd(&ioCmd);
+                        ioCmdHeld = 0;
+                    }
                 }
                 else
-                {
-                    handle_nvme_io_cmd(&nvmeCmd); // Handle IO command - read/write, flush, TRIM, etc.
-                    ReqTransSliceToLowLevel(); // Request translation to low-level
+                    PutToNvmeArbQ(&nvmeCmd); // Hold IO command in its submission queue, or in fetch order without arbitration
+            }
+
+            // Select IO command by urgent priority and weighted round robin or in fetch order, a command not admitted keeps its turn
+            if(ioCmdHeld || GetFromNvmeArbQ(&ioCmd))
+            {
+                ioCmdHeld = !DispatchNvmeIoCmd(&ioCmd);
+#if (!DUAL_CORE_FTL)
+                if(!ioCmdHeld)
                     exeLlr = 0; // Skip low-level execution
-                }
+#endif
+                // Otherwise lower layers run to release requests, new IO commands wait in the arbiter
             }
         }
         else if(g_nvmeTask.status == NVME_TASK_SHUTDOWN)
@@ -143,9 +204,19 @@ void nvme_main()
                 set_nvme_csts_shst(2); // Update shutdown status
                 g_nvmeTask.status = NVME_TASK_WAIT_RESET; // Update task status
 
+#if (DUAL_CORE_FTL)
+                // The FTL core writes back pinned entries and bad block information after the commands passed to it
+                RequestFtlCore(FTL_CORE_REQ_SHUTDOWN, 0, 0);
+#else
+                // Write back pinned data buffer entries
+                FlushPinnedDataBuf();
+
                 // Flush bad block information
                 UpdateBadBlockTableForGrownBadBlock(RESERVED_DATA_BUFFER_BASE_ADDR);
 
+                ReportReqPoolStat(); // Request slot usage since power on
+#endif
+
                 xil_printf("\r\nNVMe shutdown!!!\r\n");
             }
         }
@@ -190,13 +261,93 @@ void nvme_main()
             xil_printf("\r\nNVMe reset!!!\r\n");
         }
 
+#if (DUAL_CORE_FTL)
+        // Issue the DMA requested by the FTL core and report the finished ones
+        ServiceNvmeDmaReq();
+#else
+#if (BACKGROUND_WRITE_BACK)
+        // Clean dirty data buffer entries while no host command arrived
+        if(exeLlr && (g_nvmeTask.status == NVME_TASK_RUNNING))
+            WriteBackDataBuf();
+#endif
+
         // Execute low-level requests if applicable
         if(exeLlr && ((nvmeDmaReqQ.headReq != REQ_SLOT_TAG_NONE) || notCompletedNandReqCnt || blockedReqCnt))
         {
             CheckDoneNvmeDmaReq(); // Check completed NVMe DMA requests
             SchedulingNandReq(); // Schedule NAND requests
         }
+#endif
+    }
+}
+
+#if (DUAL_CORE_FTL)
+// Main function of the FTL core
+void ftl_core_main()
+{
+    NVME_COMMAND ioCmd; // IO command waiting for admission
+    unsigned int ioCmdHeld = 0; // Flag of the held IO command
+    unsigned int ftlCoreReq, sliceCnt;
+
+    // Wait until the host interface core initialized the FTL
+    while(coreRingMapPtr->ftlCoreState != FTL_CORE_STATE_RUN)
+        ;
+
+    while(1)
+    {
+        // IO command passed by the host interface core, admitted here since this core owns the request pool and data buffer counters
+        if(ioCmdHeld || GetFromCoreCmdRing(&coreRingMapPtr->ioCmdRing, &ioCmd))
+        {
+            sliceCnt = get_nvme_io_cmd_slice_cnt(&ioCmd);
+            ioCmdHeld = (AdmitNvmeIoCmd(sliceCnt) != ADMISSION_REPORT_DONE);
+            if(!ioCmdHeld)
+            {
+                handle_nvme_io_cmd(&ioCmd); // Handle IO command - read/write, flush, TRIM, etc.
+                ReqTransSliceToLowLevel(); // Request translation to low-level
+                ReleaseNvmeIoCmdAdmission(sliceCnt); // The requests are allocated now
+                continue;
+            }
+            // Otherwise lower layers run to release requests, later commands wait in the ring behind the held one
+        }
+
+        // Serve the host interface core once every IO command passed before the request is handled
+        ftlCoreReq = coreRingMapPtr->ftlCoreReq;
+        if(!ioCmdHeld && (ftlCoreReq != FTL_CORE_REQ_NONE))
+        {
+            if(ftlCoreReq == FTL_CORE_REQ_SHUTDOWN)
+            {
+                FlushPinnedDataBuf(); // Write back pinned data buffer entries
+                UpdateBadBlockTableForGrownBadBlock(RESERVED_DATA_BUFFER_BASE_ADDR); // Flush bad block information
+                ReportReqPoolStat(); // Request slot usage since power on
+                coreRingMapPtr->ftlCoreReqReport = 0;
+            }
+            else if(ftlCoreReq == FTL_CORE_REQ_PIN)
+                coreRingMapPtr->ftlCoreReqReport = PinDataBufRange(coreRingMapPtr->ftlCoreReqArg[0], coreRingMapPtr->ftlCoreReqArg[1]);
+            else if(ftlCoreReq == FTL_CORE_REQ_UNPIN)
+                coreRingMapPtr->ftlCoreReqReport = UnpinDataBufRange(coreRingMapPtr->ftlCoreReqArg[0], coreRingMapPtr->ftlCoreReqArg[1]);
+            else
+            {
+                xil_printf("Not Support FTL core request: %d\r\n", ftlCoreReq);
+                ASSERT(0);
+            }
+
+            __sync_synchronize();
+            coreRingMapPtr->ftlCoreReq = FTL_CORE_REQ_NONE;
+        }
+
+#if (BACKGROUND_WRITE_BACK)
+        // Clean dirty data buffer entries while no host command arrived
+        WriteBackDataBuf();
+#endif
+
+        // Execute low-level requests
+        if((nvmeDmaReqQ.headReq != REQ_SLOT_TAG_NONE) || notCompletedNandReqCnt || blockedReqCnt)
+        {
+            CheckDoneNvmeDmaReq(); // Check completed NVMe DMA requests
+            SchedulingNandReq(); // Schedule NAND requests
+        }
     }
 }
+#endif
 
 
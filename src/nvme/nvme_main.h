@@ -49,5 +49,6 @@
 #define __NVME_MAIN_H_
 
 void nvme_main();
+void ftl_core_main();
 
 #endif	//__NVME_MAIN_H_
@@ -44,6 +44,7 @@
 //////////////////////////////////////////////////////////////////////////////////
 
 #include "xil_printf.h"
+#include "xtime_l.h"
 #include <assert.h>
 #include "memory_map.h"
 
@@ -64,8 +65,11 @@ void InitReqPool()
 
 	reqPoolPtr = (P_REQ_POOL) REQ_POOL_ADDR; //revise address
 
-	freeReqQ.headReq = 0;
-	freeReqQ.tailReq = AVAILABLE_OUNTSTANDING_REQ_COUNT - 1;
+	freeReqQ.head = 0;
+	freeReqQ.reservedReqCnt = 0;
+	freeReqQ.maxUsedReqCnt = 0;
+	freeReqQ.waitCnt = 0;
+	freeReqQ.waitTicks = 0;
 
 	sliceReqQ.headReq = REQ_SLOT_TAG_NONE;
 	sliceReqQ.tailReq = REQ_SLOT_TAG_NONE;
@@ -96,11 +100,10 @@ void InitReqPool()
 		reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_FREE;
 		reqPoolPtr->reqPool[reqSlotTag].prevBlockingReq = REQ_SLOT_TAG_NONE;
 		reqPoolPtr->reqPool[reqSlotTag].nextBlockingReq = REQ_SLOT_TAG_NONE;
-		reqPoolPtr->reqPool[reqSlotTag].prevReq = reqSlotTag - 1;
+		reqPoolPtr->reqPool[reqSlotTag].prevReq = REQ_SLOT_TAG_NONE;
 		reqPoolPtr->reqPool[reqSlotTag].nextReq = reqSlotTag + 1;
 	}
 
-	reqPoolPtr->reqPool[0].prevReq = REQ_SLOT_TAG_NONE;
 	reqPoolPtr->reqPool[AVAILABLE_OUNTSTANDING_REQ_COUNT - 1].nextReq = REQ_SLOT_TAG_NONE;
 	freeReqQ.reqCnt = AVAILABLE_OUNTSTANDING_REQ_COUNT;
 
@@ -111,52 +114,122 @@ void InitReqPool()
 
 void PutToFreeReqQ(unsigned int reqSlotTag)
 {
-	if(freeReqQ.tailReq != REQ_SLOT_TAG_NONE)
+	unsigned int head, newHead;
+
+	//the slot may be taken again as soon as it is linked, so it is marked free beforehand
+	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_FREE;
+	reqPoolPtr->reqPool[reqSlotTag].prevReq = REQ_SLOT_TAG_NONE;
+
+	do
 	{
-		reqPoolPtr->reqPool[reqSlotTag].prevReq = freeReqQ.tailReq;
-		reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
-		reqPoolPtr->reqPool[freeReqQ.tailReq].nextReq = reqSlotTag;
-		freeReqQ.tailReq = reqSlotTag;
+		head = freeReqQ.head;
+		reqPoolPtr->reqPool[reqSlotTag].nextReq = FREE_REQ_HEAD_SLOT(head);
+		newHead = ((head + FREE_REQ_HEAD_TAG_UNIT) & ~0xffff) | reqSlotTag;
+	} while(!__sync_bool_compare_and_swap(&freeReqQ.head, head, newHead));
+
+	__sync_fetch_and_add(&freeReqQ.reqCnt, 1);
+}
+
+static unsigned int PopFreeReqQ()
+{
+	unsigned int reqSlotTag, head, newHead, usedReqCnt, maxUsedReqCnt;
+	XTime issueTime;
+
+	while(1)
+	{
+		head = freeReqQ.head;
+		reqSlotTag = FREE_REQ_HEAD_SLOT(head);
+
+		if(reqSlotTag == REQ_SLOT_TAG_NONE)
+		{
+			SyncAvailFreeReq();
+			continue;
+		}
+
+		//nextReq may be stale if another allocator took the slot meanwhile, the tag makes the swap fail then
+		newHead = ((head + FREE_REQ_HEAD_TAG_UNIT) & ~0xffff) | reqPoolPtr->reqPool[reqSlotTag].nextReq;
+		if(__sync_bool_compare_and_swap(&freeReqQ.head, head, newHead))
+			break;
 	}
-	else
+
+	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_NONE;
+	reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFill = REQ_OPT_DATA_BUF_FILL_NONE;
+
+	usedReqCnt = AVAILABLE_OUNTSTANDING_REQ_COUNT - (__sync_sub_and_fetch(&freeReqQ.reqCnt, 1));
+	maxUsedReqCnt = freeReqQ.maxUsedReqCnt;
+	while(usedReqCnt > maxUsedReqCnt)
 	{
-		reqPoolPtr->reqPool[reqSlotTag].prevReq = REQ_SLOT_TAG_NONE;
-		reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
-		freeReqQ.headReq = reqSlotTag;
-		freeReqQ.tailReq = reqSlotTag;
+		if(__sync_bool_compare_and_swap(&freeReqQ.maxUsedReqCnt, maxUsedReqCnt, usedReqCnt))
+			break;
+		maxUsedReqCnt = freeReqQ.maxUsedReqCnt;
 	}
 
-	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_FREE;
-	freeReqQ.reqCnt++;
+	XTime_GetTime(&issueTime);
+	reqPoolPtr->reqPool[reqSlotTag].issueTime = (unsigned int)issueTime;
+
+	return reqSlotTag;
 }
 
+//the slot is taken from the reservation of the NVMe IO command being transformed, if any
+//eviction, write-back and garbage collection run on behalf of the command during the transform, so they draw it down as well
 unsigned int GetFromFreeReqQ()
 {
 	unsigned int reqSlotTag;
 
-	reqSlotTag = freeReqQ.headReq;
+	reqSlotTag = PopFreeReqQ();
+	if(freeReqQ.reservedReqCnt)
+		freeReqQ.reservedReqCnt--;
 
-	if(reqSlotTag == REQ_SLOT_TAG_NONE)
-	{
-		SyncAvailFreeReq();
-		reqSlotTag = freeReqQ.headReq;
-	}
+	return reqSlotTag;
+}
 
-	if(reqPoolPtr->reqPool[reqSlotTag].nextReq != REQ_SLOT_TAG_NONE)
-	{
-		freeReqQ.headReq = reqPoolPtr->reqPool[reqSlotTag].nextReq;
-		reqPoolPtr->reqPool[reqPoolPtr->reqPool[reqSlotTag].nextReq].prevReq = REQ_SLOT_TAG_NONE;
-	}
-	else
-	{
-		freeReqQ.headReq = REQ_SLOT_TAG_NONE;
-		freeReqQ.tailReq = REQ_SLOT_TAG_NONE;
-	}
+//for speculative requests, which check the reservation beforehand and must leave it to the command
+unsigned int GetUnreservedFromFreeReqQ()
+{
+	return PopFreeReqQ();
+}
 
-	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_NONE;
-	freeReqQ.reqCnt--;
+unsigned int IsFreeReqQEmpty()
+{
+	return (FREE_REQ_HEAD_SLOT(freeReqQ.head) == REQ_SLOT_TAG_NONE);
+}
 
-	return reqSlotTag;
+//reserves slots for one NVMe IO command at a time, GetFromFreeReqQ draws the reservation down until UnreserveFreeReq drops the rest
+//only speculative allocations yield to it, garbage collection beyond GC_RESERVED_REQ_COUNT and the free pages it needs are not covered
+unsigned int ReserveFreeReq(unsigned int reqCnt)
+{
+	unsigned int reservedReqCnt;
+
+	//a command larger than the host share is admitted once every other threshold is dropped
+	if(reqCnt > AVAILABLE_OUNTSTANDING_REQ_COUNT - GC_RESERVED_REQ_COUNT)
+		reqCnt = AVAILABLE_OUNTSTANDING_REQ_COUNT - GC_RESERVED_REQ_COUNT;
+
+	//thresholds are raised and dropped by the FTL core only, slots freed by the other core can only make room meanwhile
+	reservedReqCnt = freeReqQ.reservedReqCnt;
+	if(freeReqQ.reqCnt < reservedReqCnt + reqCnt + GC_RESERVED_REQ_COUNT)
+		return 0;
+
+	freeReqQ.reservedReqCnt += reqCnt;
+	return 1;
+}
+
+void UnreserveFreeReq()
+{
+	freeReqQ.reservedReqCnt = 0;
+}
+
+void RecordFreeReqWait(unsigned int waitTicks)
+{
+	__sync_fetch_and_add(&freeReqQ.waitCnt, 1);
+	__sync_fetch_and_add(&freeReqQ.waitTicks, (unsigned long long)waitTicks);
+}
+
+void ReportReqPoolStat()
+{
+	xil_printf("[ request pool: %d / %d slots used at most, %d waits for a free slot, %d us waited ]\r\n",
+			freeReqQ.maxUsedReqCnt, AVAILABLE_OUNTSTANDING_REQ_COUNT, freeReqQ.waitCnt,
+			(unsigned int)(freeReqQ.waitTicks / (COUNTS_PER_SECOND / 1000000)));
 }
 
 void PutToSliceReqQ(unsigned int reqSlotTag)
@@ -283,6 +356,12 @@ void PutToBlockedByRowAddrDepReqQ(unsigned int reqSlotTag, unsigned int chNo, un
 	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_BLOCKED_BY_ROW_ADDR_DEP;
 	blockedByRowAddrDepReqQ[chNo][wayNo].reqCnt++;
 	blockedReqCnt++;
+#if (CHANNEL_ACTIVITY_MASK)
+	SetNandWayActive(chNo, wayNo);
+#endif
+#if (NAND_COMPLETION_EVENT)
+	nandChEventMask |= (1 << chNo);
+#endif
 }
 void SelectiveGetFromBlockedByRowAddrDepReqQ(unsigned int reqSlotTag, unsigned int chNo, unsigned int wayNo)
 {
@@ -396,6 +475,12 @@ void PutToNandReqQ(unsigned int reqSlotTag, unsigned chNo, unsigned wayNo)
 	reqPoolPtr->reqPool[reqSlotTag].reqQueueType = REQ_QUEUE_TYPE_NAND;
 	nandReqQ[chNo][wayNo].reqCnt++;
 	notCompletedNandReqCnt++;
+#if (CHANNEL_ACTIVITY_MASK)
+	SetNandWayActive(chNo, wayNo);
+#endif
+#if (NAND_COMPLETION_EVENT)
+	nandChEventMask |= (1 << chNo);
+#endif
 }
 
 void GetFromNandReqQ(unsigned int chNo, unsigned int wayNo, unsigned int reqStatus, unsigned int reqCode)
@@ -424,3 +509,64 @@ void GetFromNandReqQ(unsigned int chNo, unsigned int wayNo, unsigned int reqStat
 	PutToFreeReqQ(reqSlotTag);
 	ReleaseBlockedByBufDepReq(reqSlotTag);
 }
+
+//the request leaves the queue without completing, it stays counted as a not completed NAND request
+void SelectiveGetFromNandReqQ(unsigned int reqSlotTag, unsigned int chNo, unsigned int wayNo)
+{
+	unsigned int prevReq, nextReq;
+
+	if(reqSlotTag == REQ_SLOT_TAG_NONE)
+		assert(!"[WARNING] Wrong reqSlotTag [WARNING]");
+
+	prevReq = reqPoolPtr->reqPool[reqSlotTag].prevReq;
+	nextReq = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+
+	if((nextReq != REQ_SLOT_TAG_NONE) && (prevReq != REQ_SLOT_TAG_NONE))
+	{
+		reqPoolPtr->reqPool[prevReq].nextReq = nextReq;
+		reqPoolPtr->reqPool[nextReq].prevReq = prevReq;
+	}
+	else if((nextReq == REQ_SLOT_TAG_NONE) && (prevReq != REQ_SLOT_TAG_NONE))
+	{
+		reqPoolPtr->reqPool[prevReq].nextReq = REQ_SLOT_TAG_NONE;
+		nandReqQ[chNo][wayNo].tailReq = prevReq;
+	}
+	else if((nextReq != REQ_SLOT_TAG_NONE) && (prevReq == REQ_SLOT_TAG_NONE))
+	{
+		reqPoolPtr->reqPool[nextReq].prevReq = REQ_SLOT_TAG_NONE;
+		nandReqQ[chNo][wayNo].headReq = nextReq;
+	}
+	else
+	{
+		nandReqQ[chNo][wayNo].headReq = REQ_SLOT_TAG_NONE;
+		nandReqQ[chNo][wayNo].tailReq = REQ_SLOT_TAG_NONE;
+	}
+
+	nandReqQ[chNo][wayNo].reqCnt--;
+}
+
+void PutToNandReqQHead(unsigned int reqSlotTag, unsigned chNo, unsigned wayNo)
+{
+	if(nandReqQ[chNo][wayNo].headReq != REQ_SLOT_TAG_NONE)
+	{
+		reqPoolPtr->reqPool[reqSlotTag].prevReq = REQ_SLOT_TAG_NONE;
+		reqPoolPtr->reqPool[reqSlotTag].nextReq = nandReqQ[chNo][wayNo].headReq;
+		reqPoolPtr->reqPool[nandReqQ[chNo][wayNo].headReq].prevReq = reqSlotTag;
+		nandReqQ[chNo][wayNo].headReq = reqSlotTag;
+	}
+	else
+	{
+		reqPoolPtr->reqPool[reqSlotTag].prevReq = REQ_SLOT_TAG_NONE;
+		reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
+		nandReqQ[chNo][wayNo].headReq = reqSlotTag;
+		nandReqQ[chNo][wayNo].tailReq = reqSlotTag;
+	}
+
+	nandReqQ[chNo][wayNo].reqCnt++;
+#if (CHANNEL_ACTIVITY_MASK)
+	SetNandWayActive(chNo, wayNo);
+#endif
+#if (NAND_COMPLETION_EVENT)
+	nandChEventMask |= (1 << chNo);
+#endif
+}
@@ -55,6 +55,11 @@
 #define REQ_SLOT_TAG_NONE		0xffff
 #define REQ_SLOT_TAG_FAIL		0xffff
 
+#define GC_RESERVED_REQ_COUNT	(USER_DIES * 2)		//free slots required above the admission threshold of a host command, one copy read and write per die keeps garbage collection going
+
+#define FREE_REQ_HEAD_SLOT(head)	((head) & 0xffff)
+#define FREE_REQ_HEAD_TAG_UNIT		0x10000
+
 typedef struct _REQ_POOL
 {
 	SSD_REQ_FORMAT reqPool[AVAILABLE_OUNTSTANDING_REQ_COUNT];
@@ -64,6 +69,13 @@ void InitReqPool();
 
 void PutToFreeReqQ(unsigned int reqSlotTag);
 unsigned int GetFromFreeReqQ();
+unsigned int GetUnreservedFromFreeReqQ();
+unsigned int IsFreeReqQEmpty();
+//covers the slots of one NVMe IO command, not garbage collection beyond GC_RESERVED_REQ_COUNT nor the free pages it needs
+unsigned int ReserveFreeReq(unsigned int reqCnt);
+void UnreserveFreeReq();
+void RecordFreeReqWait(unsigned int waitTicks);
+void ReportReqPoolStat();
 
 void PutToSliceReqQ(unsigned int reqSlotTag);
 unsigned int GetFromSliceReqQ();
@@ -79,6 +91,8 @@ void SelectiveGetFromNvmeDmaReqQ(unsigned int regSlotTag);
 
 void PutToNandReqQ(unsigned int reqSlotTag, unsigned chNo, unsigned wayNo);
 void GetFromNandReqQ(unsigned int chNo, unsigned int wayNo, unsigned int reqStatus, unsigned int reqCode);
+void SelectiveGetFromNandReqQ(unsigned int reqSlotTag, unsigned int chNo, unsigned int wayNo);
+void PutToNandReqQHead(unsigned int reqSlotTag, unsigned chNo, unsigned wayNo);
 
 extern P_REQ_POOL reqPoolPtr;
 extern FREE_REQUEST_QUEUE freeReqQ;
@@ -99,6 +99,11 @@
 #define REQ_OPT_BLOCK_SPACE_MAIN	0
 #define REQ_OPT_BLOCK_SPACE_TOTAL 	1
 
+#define REQ_OPT_DATA_BUF_FILL_NONE	0
+#define REQ_OPT_DATA_BUF_FILL_READ	1
+#define REQ_OPT_DATA_BUF_FILL_WAIT	2
+#define REQ_OPT_DATA_BUF_FILL_GC_COPY	3
+
 #define LOGICAL_SLICE_ADDR_NONE 	0xffffffff
 
 typedef struct _DATA_BUF_INFO{
@@ -114,10 +119,18 @@ typedef struct _NVME_DMA_INFO{
 	unsigned int nvmeBlockOffset : 16;
 	unsigned int numOfNvmeBlock : 16;
 	unsigned int reqTail	: 8;
-	unsigned int reserved0 : 8;
+	unsigned int tenantNo : 4;
+	unsigned int reserved0 : 4;
 	unsigned int overFlowCnt;
 } NVME_DMA_INFO, *P_NVME_DMA_INFO;
 
+typedef struct _DATA_BUF_FILL_INFO{
+	unsigned int dataBufEntry : 16;
+	unsigned int waitingReq : 16;
+	unsigned int heldSectorMask : 8;
+	unsigned int reserved0 : 24;
+} DATA_BUF_FILL_INFO, *P_DATA_BUF_FILL_INFO;
+
 
 typedef struct _NAND_INFO{
 	union {
@@ -146,7 +159,8 @@ typedef struct _REQ_OPTION{
 	unsigned int nandEccWarning : 1;
 	unsigned int rowAddrDependencyCheck : 1;
 	unsigned int blockSpace : 1;
-	unsigned int reserved0 : 24;
+	unsigned int dataBufFill : 2;
+	unsigned int reserved0 : 22;
 } REQ_OPTION, *P_REQ_OPTION;
 
 
@@ -161,7 +175,10 @@ typedef struct _SSD_REQ_FORMAT
 
 	REQ_OPTION reqOpt;
 	DATA_BUF_INFO dataBufInfo;
-	NVME_DMA_INFO nvmeDmaInfo;
+	union {
+		NVME_DMA_INFO nvmeDmaInfo;
+		DATA_BUF_FILL_INFO dataBufFillInfo;	//only a NAND read with REQ_OPT_DATA_BUF_FILL_READ, it never carries host DMA
+	};
 	NAND_INFO nandInfo;
 
 	unsigned int prevReq : 16;
@@ -169,6 +186,8 @@ typedef struct _SSD_REQ_FORMAT
 	unsigned int prevBlockingReq : 16;
 	unsigned int nextBlockingReq : 16;
 
+	unsigned int issueTime;		//low word of the global timer when the request was taken from the free queue
+
 } SSD_REQ_FORMAT, *P_SSD_REQ_FORMAT;
 
 #endif /* REQUEST_FORMAT_H_ */
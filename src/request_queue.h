@@ -46,12 +46,15 @@
 #define REQUEST_QUEUE_H_
 
 
+//lock-free stack linked by nextReq, the head word carries a tag bumped on every update so that a stale head never matches
 typedef struct _FREE_REQUEST_QUEUE
 {
-	unsigned int headReq : 16;
-	unsigned int tailReq : 16;
-	unsigned int reqCnt : 16;
-	unsigned int reserved0 : 16;
+	volatile unsigned int head;			//slot tag of the head in the low 16 bits, ABA tag in the high 16 bits
+	volatile unsigned int reqCnt;			//changed atomically, either core frees slots
+	volatile unsigned int reservedReqCnt;	//slots left reserved for the NVMe IO command being transformed, drawn down by its allocations, FTL core only
+	volatile unsigned int maxUsedReqCnt;	//high-water mark of the allocated slots
+	volatile unsigned int waitCnt;			//allocations which found no free slot
+	volatile unsigned long long waitTicks;	//global timer ticks spent waiting for a free slot
 } FREE_REQUEST_QUEUE, *P_FREE_REQUEST_QUEUE;
 
 typedef struct _SLICE_REQUEST_QUEUE
@@ -48,6 +48,7 @@
 
 #include <assert.h>
 #include "xil_printf.h"
+#include "xtime_l.h"
 #include "memory_map.h"
 #include "nvme/debug.h"
 
@@ -58,6 +59,10 @@ P_RETRY_LIMIT_TABLE retryLimitTablePtr;
 
 P_DIE_STATE_TABLE dieStateTablePtr;
 P_WAY_PRIORITY_TABLE wayPriorityTablePtr;
+unsigned int reqClassDeadlineTicks[REQ_CLASS_COUNT];
+unsigned int nandChEventMask;
+unsigned int nandChActiveMask;
+unsigned int nandWayActiveMask[USER_CHANNELS];
 
 void InitReqScheduler()
 {
@@ -71,6 +76,12 @@ void InitReqScheduler()
 	dieStateTablePtr = (P_DIE_STATE_TABLE) DIE_STATE_TABLE_ADDR;
 	wayPriorityTablePtr = (P_WAY_PRIORITY_TABLE) WAY_PRIORITY_TABLE_ADDR;
 
+	reqClassDeadlineTicks[REQ_CLASS_HOST_READ] = HOST_READ_TARGET_LATENCY_US * (COUNTS_PER_SECOND / 1000000);
+	reqClassDeadlineTicks[REQ_CLASS_HOST_WRITE] = HOST_WRITE_TARGET_LATENCY_US * (COUNTS_PER_SECOND / 1000000);
+	reqClassDeadlineTicks[REQ_CLASS_GC] = GC_TARGET_LATENCY_US * (COUNTS_PER_SECOND / 1000000);
+	nandChEventMask = (1 << USER_CHANNELS) - 1;
+	nandChActiveMask = 0;
+
 	for(chNo=0; chNo<USER_CHANNELS; ++chNo)
 	{
 		wayPriorityTablePtr->wayPriority[chNo].idleHead = 0;
@@ -94,6 +105,13 @@ void InitReqScheduler()
 			dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_NONE;
 			dieStateTablePtr->dieState[chNo][wayNo].prevWay = wayNo - 1;
 			dieStateTablePtr->dieState[chNo][wayNo].nextWay = wayNo + 1;
+			dieStateTablePtr->dieState[chNo][wayNo].readBypassCnt = 0;
+			dieStateTablePtr->dieState[chNo][wayNo].suspendedReq = REQ_SLOT_TAG_NONE;
+			dieStateTablePtr->dieState[chNo][wayNo].suspendReadCnt = 0;
+			dieStateTablePtr->dieState[chNo][wayNo].suspendCnt = 0;
+			dieStateTablePtr->dieState[chNo][wayNo].fusedReq = REQ_SLOT_TAG_NONE;
+			dieStateTablePtr->dieState[chNo][wayNo].cacheOp = 0;
+			dieStateTablePtr->dieState[chNo][wayNo].cacheReq = REQ_SLOT_TAG_NONE;
 
 			completeFlagTablePtr->completeFlag[chNo][wayNo] = 0;
 			statusReportTablePtr->statusReport[chNo][wayNo] = 0;
@@ -101,6 +119,8 @@ void InitReqScheduler()
 		}
 		dieStateTablePtr->dieState[chNo][0].prevWay = WAY_NONE;
 		dieStateTablePtr->dieState[chNo][USER_WAYS-1].nextWay = WAY_NONE;
+
+		nandWayActiveMask[chNo] = 0;
 	}
 }
 
@@ -117,11 +137,18 @@ void SyncAllLowLevelReqDone()
 
 void SyncAvailFreeReq()
 {
-	while(freeReqQ.headReq == REQ_SLOT_TAG_NONE)
+	XTime startTime, endTime;
+
+	XTime_GetTime(&startTime);
+
+	while(IsFreeReqQEmpty())
 	{
 		CheckDoneNvmeDmaReq();
 		SchedulingNandReq();
 	}
+
+	XTime_GetTime(&endTime);
+	RecordFreeReqWait((unsigned int)(endTime - startTime));
 }
 
 void SyncReleaseEraseReq(unsigned int chNo, unsigned int wayNo, unsigned int blockNo)
@@ -133,12 +160,93 @@ void SyncReleaseEraseReq(unsigned int chNo, unsigned int wayNo, unsigned int blo
 	}
 }
 
+//garbage collection returns with every copied slice mapped to its copy, the host must not look up the erased victim
+void SyncReleaseGcCopy()
+{
+#if (REVERSE_MAP_IN_SPARE)
+	while(gcCopyReadCnt)
+	{
+		CheckDoneNvmeDmaReq();
+		SchedulingNandReq();
+	}
+#endif
+}
+
 void SchedulingNandReq()
 {
 	int chNo;
+#if (CHANNEL_ACTIVITY_MASK)
+	unsigned int chMask;
 
+	//only the channels holding queued or running requests are visited
+	chMask = nandChActiveMask;
+	while(chMask)
+	{
+		chNo = __builtin_ctz(chMask);
+		chMask &= chMask - 1;
+#else
 	for(chNo = 0; chNo < USER_CHANNELS; chNo++)
+	{
+#endif
+#if (NAND_COMPLETION_EVENT)
+		//a channel is visited when a request was queued to it or the controller signals progress of its running requests
+		if(!(nandChEventMask & (1 << chNo)))
+			if(!CheckNandChEvent(chNo))
+				continue;
+
+		nandChEventMask &= ~(1 << chNo);
+#endif
 		SchedulingNandReqPerCh(chNo);
+	}
+}
+
+unsigned int CheckNandChEvent(unsigned int chNo)
+{
+	unsigned int readyBusy, wayNo;
+
+	//completion flags and status reports are written to DRAM by the controller
+	wayNo = wayPriorityTablePtr->wayPriority[chNo].statusReportHead;
+	while(wayNo != WAY_NONE)
+	{
+		if(dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt == REQ_STATUS_CHECK_OPT_COMPLETION_FLAG)
+		{
+			if(V2FTransferComplete(completeFlagTablePtr->completeFlag[chNo][wayNo]))
+				return 1;
+		}
+		else if(dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt == REQ_STATUS_CHECK_OPT_REPORT)
+		{
+			if(V2FRequestReportDone(statusReportTablePtr->statusReport[chNo][wayNo]))
+				return 1;
+		}
+		else
+			return 1;
+
+		wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+	}
+
+	if(V2FIsControllerBusy(&chCtlReg[chNo]))
+		return 0;
+
+	//the controller accepts commands again, waiting requests can be issued
+	if((wayPriorityTablePtr->wayPriority[chNo].readTriggerHead != WAY_NONE) || (wayPriorityTablePtr->wayPriority[chNo].writeHead != WAY_NONE) ||
+			(wayPriorityTablePtr->wayPriority[chNo].eraseHead != WAY_NONE) || (wayPriorityTablePtr->wayPriority[chNo].readTransferHead != WAY_NONE))
+		return 1;
+
+	//a die running a read, program or erase became ready
+	if(wayPriorityTablePtr->wayPriority[chNo].statusCheckHead != WAY_NONE)
+	{
+		readyBusy = V2FReadyBusyAsync(&chCtlReg[chNo]);
+		wayNo = wayPriorityTablePtr->wayPriority[chNo].statusCheckHead;
+		while(wayNo != WAY_NONE)
+		{
+			if(V2FWayReady(readyBusy, wayNo))
+				return 1;
+
+			wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+		}
+	}
+
+	return 0;
 }
 
 void SchedulingNandReqPerCh(unsigned int chNo)
@@ -160,6 +268,9 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 				nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
 
 				SelectivGetFromNandIdleList(chNo, wayNo);
+#if (NAND_READ_BYPASS)
+				SelectNandReqQHead(chNo, wayNo);
+#endif
 				PutToNandWayPriorityTable(nandReqQ[chNo][wayNo].headReq, chNo, wayNo);
 				wayNo = nextWay;
 			}
@@ -184,15 +295,38 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 
 				if(reqStatus != REQ_STATUS_RUNNING)
 				{
+#if (NAND_SUSPEND_RESUME || NAND_READ_BYPASS)
+					unsigned int reqSlotTag;
+
+					reqSlotTag = nandReqQ[chNo][wayNo].headReq;
+#endif
 					ExecuteNandReq(chNo, wayNo, reqStatus);
 					nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
 					SelectivGetFromNandStatusReportList(chNo, wayNo);
 
+#if (NAND_SUSPEND_RESUME)
+					//a request left the queue, the suspended operation resumes unless the next request is another read it lets through
+					if(nandReqQ[chNo][wayNo].headReq != reqSlotTag)
+						if(UpdateNandSuspend(chNo, wayNo) == NAND_SUSPEND_REPORT_RESUMED)
+						{
+							PutToNandStatusCheckList(chNo, wayNo);
+							wayNo = nextWay;
+							continue;
+						}
+#endif
+
 					if(nandReqQ[chNo][wayNo].headReq == REQ_SLOT_TAG_NONE)
 						ReleaseBlockedByRowAddrDepReq(chNo, wayNo);
 
 					if(nandReqQ[chNo][wayNo].headReq != REQ_SLOT_TAG_NONE)
+					{
+#if (NAND_READ_BYPASS)
+						//only between requests, a read that finished its trigger still owns the way for the transfer
+						if(nandReqQ[chNo][wayNo].headReq != reqSlotTag)
+							SelectNandReqQHead(chNo, wayNo);
+#endif
 						PutToNandWayPriorityTable(nandReqQ[chNo][wayNo].headReq, chNo, wayNo);
+					}
 					else
 					{
 						PutToNandIdleList(chNo, wayNo);
@@ -242,10 +376,63 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 						if(V2FIsControllerBusy(&chCtlReg[chNo]))
 							return;
 					}
+#if (NAND_SUSPEND_RESUME)
+					else if(CheckNandSuspendRequired(chNo, wayNo))
+					{
+						//the die reports ready once it is suspended, then the read at the queue head is scheduled as usual
+						nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+						SelectiveGetFromNandStatusCheckList(chNo,wayNo);
+						SuspendNandReq(chNo, wayNo);
+						PutToNandStatusReportList(chNo, wayNo);
+
+						if(V2FIsControllerBusy(&chCtlReg[chNo]))
+							return;
+
+						wayNo = nextWay;
+						continue;
+					}
+#endif
 
 					wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
 				}
 			}
+#if (DEADLINE_SCHEDULING)
+			//the statuses are checked first, then the ways waiting to issue are served in order of their head request deadline
+			wayNo = SelectEarliestDeadlineWay(chNo);
+			while(wayNo != WAY_NONE)
+			{
+				unsigned int reqCode;
+
+				reqCode = reqPoolPtr->reqPool[nandReqQ[chNo][wayNo].headReq].reqCode;
+				ExecuteNandReq(chNo, wayNo, REQ_STATUS_RUNNING);
+
+				if(reqCode == REQ_CODE_READ)
+				{
+					SelectiveGetFromNandReadTriggerList(chNo, wayNo);
+					PutToNandStatusCheckList(chNo, wayNo);
+				}
+				else if(reqCode == REQ_CODE_READ_TRANSFER)
+				{
+					SelectiveGetFromNandReadTransferList(chNo, wayNo);
+					PutToNandStatusReportList(chNo, wayNo);
+				}
+				else if(reqCode == REQ_CODE_ERASE)
+				{
+					SelectiveGetFromNandEraseList(chNo, wayNo);
+					PutToNandStatusCheckList(chNo, wayNo);
+				}
+				else
+				{
+					SelectiveGetFromNandWriteList(chNo, wayNo);
+					PutToNandStatusCheckList(chNo, wayNo);
+				}
+
+				if(V2FIsControllerBusy(&chCtlReg[chNo]))
+					return;
+
+				wayNo = SelectEarliestDeadlineWay(chNo);
+			}
+#else
 			if(wayPriorityTablePtr->wayPriority[chNo].readTriggerHead != WAY_NONE)
 			{
 				wayNo = wayPriorityTablePtr->wayPriority[chNo].readTriggerHead;
@@ -316,6 +503,7 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 					wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
 				}
 			}
+#endif
 		}
 
 }
@@ -337,6 +525,19 @@ void PutToNandWayPriorityTable(unsigned int reqSlotTag, unsigned int chNo, unsig
 
 }
 
+void SetNandWayActive(unsigned int chNo, unsigned int wayNo)
+{
+	nandWayActiveMask[chNo] |= (1 << wayNo);
+	nandChActiveMask |= (1 << chNo);
+}
+
+void ClearNandWayActive(unsigned int chNo, unsigned int wayNo)
+{
+	nandWayActiveMask[chNo] &= ~(1 << wayNo);
+	if(nandWayActiveMask[chNo] == 0)
+		nandChActiveMask &= ~(1 << chNo);
+}
+
 void PutToNandIdleList(unsigned int chNo, unsigned int wayNo)
 {
 	if(wayPriorityTablePtr->wayPriority[chNo].idleTail != WAY_NONE)
@@ -353,6 +554,12 @@ void PutToNandIdleList(unsigned int chNo, unsigned int wayNo)
 		wayPriorityTablePtr->wayPriority[chNo].idleHead = wayNo;
 		wayPriorityTablePtr->wayPriority[chNo].idleTail = wayNo;
 	}
+
+#if (CHANNEL_ACTIVITY_MASK)
+	//a way waiting on blocked requests stays active so that they are released
+	if((nandReqQ[chNo][wayNo].headReq == REQ_SLOT_TAG_NONE) && (blockedByRowAddrDepReqQ[chNo][wayNo].headReq == REQ_SLOT_TAG_NONE))
+		ClearNandWayActive(chNo, wayNo);
+#endif
 }
 
 
@@ -641,9 +848,10 @@ void SelectiveGetFromNandStatusCheckList(unsigned int chNo, unsigned int wayNo)
 
 void IssueNandReq(unsigned int chNo, unsigned int wayNo)
 {
-	unsigned int reqSlotTag, rowAddr;
+	unsigned int reqSlotTag, rowAddr, fusedReqSlotTag, cacheReqSlotTag;
 	void* dataBufAddr;
 	void* spareDataBufAddr;
+	void* fusedSpareDataBufAddr;
 	unsigned int* errorInfo;
 	unsigned int* completion;
 
@@ -652,11 +860,21 @@ void IssueNandReq(unsigned int chNo, unsigned int wayNo)
 	dataBufAddr = (void*)GenerateDataBufAddr(reqSlotTag);
 	spareDataBufAddr = (void*)GenerateSpareDataBufAddr(reqSlotTag);
 
+	fusedReqSlotTag = REQ_SLOT_TAG_NONE;
+#if (MULTI_PLANE_OPERATION)
+	fusedReqSlotTag = SelectNandPlaneFusedReq(chNo, wayNo);
+#endif
+	dieStateTablePtr->dieState[chNo][wayNo].fusedReq = fusedReqSlotTag;
+	dieStateTablePtr->dieState[chNo][wayNo].cacheOp = 0;
+
 	if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ)
 	{
 		dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_CHECK;
 
-		V2FReadPageTriggerAsync(&chCtlReg[chNo], wayNo, rowAddr);
+		if(fusedReqSlotTag != REQ_SLOT_TAG_NONE)
+			v2fExtOps.readPageTriggerMultiPlaneAsync(&chCtlReg[chNo], wayNo, rowAddr, GenerateNandRowAddr(fusedReqSlotTag));
+		else
+			V2FReadPageTriggerAsync(&chCtlReg[chNo], wayNo, rowAddr);
 	}
 	else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER)
 	{
@@ -665,7 +883,19 @@ void IssueNandReq(unsigned int chNo, unsigned int wayNo)
 		errorInfo = (unsigned int*)(&eccErrorInfoTablePtr->errorInfo[chNo][wayNo]);
 		completion = (unsigned int*)(&completeFlagTablePtr->completeFlag[chNo][wayNo]);
 
-		if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc == REQ_OPT_NAND_ECC_ON)
+		cacheReqSlotTag = REQ_SLOT_TAG_NONE;
+#if (NAND_CACHE_OPERATION)
+		cacheReqSlotTag = SelectNandCacheReq(chNo, wayNo);
+
+		//this page was read behind the previous transfer, the cache read ends unless another read follows
+		if((dieStateTablePtr->dieState[chNo][wayNo].cacheReq == reqSlotTag) && (cacheReqSlotTag == REQ_SLOT_TAG_NONE))
+			v2fExtOps.readCacheEndAsync(&chCtlReg[chNo], wayNo);
+		dieStateTablePtr->dieState[chNo][wayNo].cacheReq = cacheReqSlotTag;
+#endif
+
+		if(cacheReqSlotTag != REQ_SLOT_TAG_NONE)
+			v2fExtOps.readPageTransferCacheAsync(&chCtlReg[chNo], wayNo, dataBufAddr, spareDataBufAddr, errorInfo, completion, rowAddr, GenerateNandRowAddr(cacheReqSlotTag));
+		else if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc == REQ_OPT_NAND_ECC_ON)
 			V2FReadPageTransferAsync(&chCtlReg[chNo], wayNo, dataBufAddr, spareDataBufAddr, errorInfo, completion, rowAddr);
 		else
 			V2FReadPageTransferRawAsync(&chCtlReg[chNo], wayNo, dataBufAddr, completion);
@@ -674,7 +904,28 @@ void IssueNandReq(unsigned int chNo, unsigned int wayNo)
 	{
 		dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_CHECK;
 
-		V2FProgramPageAsync(&chCtlReg[chNo], wayNo, rowAddr, dataBufAddr, spareDataBufAddr);
+		//lsa tag for rebuilding the reverse mapping from the spare region
+		if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr == REQ_OPT_NAND_ADDR_VSA)
+			((P_SPARE_LSA_TAG)spareDataBufAddr)->logicalSliceAddr = reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr;
+
+#if (NAND_CACHE_OPERATION)
+		//the data input of the next page overlaps the program of this one
+		if(SelectNandCacheReq(chNo, wayNo) != REQ_SLOT_TAG_NONE)
+			dieStateTablePtr->dieState[chNo][wayNo].cacheOp = 1;
+#endif
+
+		if(fusedReqSlotTag != REQ_SLOT_TAG_NONE)
+		{
+			fusedSpareDataBufAddr = (void*)GenerateSpareDataBufAddr(fusedReqSlotTag);
+			((P_SPARE_LSA_TAG)fusedSpareDataBufAddr)->logicalSliceAddr = reqPoolPtr->reqPool[fusedReqSlotTag].logicalSliceAddr;
+
+			v2fExtOps.programPageMultiPlaneAsync(&chCtlReg[chNo], wayNo, rowAddr, dataBufAddr, spareDataBufAddr,
+					GenerateNandRowAddr(fusedReqSlotTag), (void*)GenerateDataBufAddr(fusedReqSlotTag), fusedSpareDataBufAddr);
+		}
+		else if(dieStateTablePtr->dieState[chNo][wayNo].cacheOp)
+			v2fExtOps.programPageCacheAsync(&chCtlReg[chNo], wayNo, rowAddr, dataBufAddr, spareDataBufAddr);
+		else
+			V2FProgramPageAsync(&chCtlReg[chNo], wayNo, rowAddr, dataBufAddr, spareDataBufAddr);
 	}
 	else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_ERASE)
 	{
@@ -699,6 +950,121 @@ void IssueNandReq(unsigned int chNo, unsigned int wayNo)
 
 }
 
+unsigned int SelectNandPlaneFusedReq(unsigned int chNo, unsigned int wayNo)
+{
+	unsigned int reqSlotTag, nextReqSlotTag, rowAddr, nextRowAddr;
+
+	//reads going ahead of a suspended operation run alone
+	if(dieStateTablePtr->dieState[chNo][wayNo].suspendedReq != REQ_SLOT_TAG_NONE)
+		return REQ_SLOT_TAG_NONE;
+
+	reqSlotTag = nandReqQ[chNo][wayNo].headReq;
+	nextReqSlotTag = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+	if(nextReqSlotTag == REQ_SLOT_TAG_NONE)
+		return REQ_SLOT_TAG_NONE;
+
+	if((reqPoolPtr->reqPool[reqSlotTag].reqCode != REQ_CODE_READ) && (reqPoolPtr->reqPool[reqSlotTag].reqCode != REQ_CODE_WRITE))
+		return REQ_SLOT_TAG_NONE;
+	if(reqPoolPtr->reqPool[nextReqSlotTag].reqCode != reqPoolPtr->reqPool[reqSlotTag].reqCode)
+		return REQ_SLOT_TAG_NONE;
+
+	//an operation is fused only when the driver provides its multi-plane routine
+	if((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ) && !v2fExtOps.readPageTriggerMultiPlaneAsync)
+		return REQ_SLOT_TAG_NONE;
+	if((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_WRITE) && !v2fExtOps.programPageMultiPlaneAsync)
+		return REQ_SLOT_TAG_NONE;
+	if((reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr != REQ_OPT_NAND_ADDR_VSA) || (reqPoolPtr->reqPool[nextReqSlotTag].reqOpt.nandAddr != REQ_OPT_NAND_ADDR_VSA))
+		return REQ_SLOT_TAG_NONE;
+
+	//same lun and page offset, different plane
+	rowAddr = GenerateNandRowAddr(reqSlotTag);
+	nextRowAddr = GenerateNandRowAddr(nextReqSlotTag);
+	if((rowAddr / LUN_1_BASE_ADDR) != (nextRowAddr / LUN_1_BASE_ADDR))
+		return REQ_SLOT_TAG_NONE;
+	if((rowAddr % PAGES_PER_MLC_BLOCK) != (nextRowAddr % PAGES_PER_MLC_BLOCK))
+		return REQ_SLOT_TAG_NONE;
+	if((((rowAddr % LUN_1_BASE_ADDR) / PAGES_PER_MLC_BLOCK) % PLANES_PER_LUN) == (((nextRowAddr % LUN_1_BASE_ADDR) / PAGES_PER_MLC_BLOCK) % PLANES_PER_LUN))
+		return REQ_SLOT_TAG_NONE;
+
+	return nextReqSlotTag;
+}
+
+unsigned int SelectNandCacheReq(unsigned int chNo, unsigned int wayNo)
+{
+	unsigned int reqSlotTag, nextReqSlotTag;
+
+	if(dieStateTablePtr->dieState[chNo][wayNo].suspendedReq != REQ_SLOT_TAG_NONE)
+		return REQ_SLOT_TAG_NONE;
+	if(dieStateTablePtr->dieState[chNo][wayNo].fusedReq != REQ_SLOT_TAG_NONE)
+		return REQ_SLOT_TAG_NONE;
+
+	reqSlotTag = nandReqQ[chNo][wayNo].headReq;
+	nextReqSlotTag = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+	if(nextReqSlotTag == REQ_SLOT_TAG_NONE)
+		return REQ_SLOT_TAG_NONE;
+	if((reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr != REQ_OPT_NAND_ADDR_VSA) || (reqPoolPtr->reqPool[nextReqSlotTag].reqOpt.nandAddr != REQ_OPT_NAND_ADDR_VSA))
+		return REQ_SLOT_TAG_NONE;
+
+	//a sequence is opened only when the driver provides its cache routines
+	if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_WRITE)
+	{
+		if(!v2fExtOps.programPageCacheAsync)
+			return REQ_SLOT_TAG_NONE;
+		if(reqPoolPtr->reqPool[nextReqSlotTag].reqCode != REQ_CODE_WRITE)
+			return REQ_SLOT_TAG_NONE;
+	}
+	else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER)
+	{
+		if(!v2fExtOps.readPageTransferCacheAsync || !v2fExtOps.readCacheEndAsync)
+			return REQ_SLOT_TAG_NONE;
+#if (MULTI_PLANE_OPERATION)
+		//a multi-plane trigger leaves a page in both planes, the cache read only follows single-plane pages
+		return REQ_SLOT_TAG_NONE;
+#endif
+		if(reqPoolPtr->reqPool[nextReqSlotTag].reqCode != REQ_CODE_READ)
+			return REQ_SLOT_TAG_NONE;
+		if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc != REQ_OPT_NAND_ECC_ON)
+			return REQ_SLOT_TAG_NONE;
+	}
+	else
+		return REQ_SLOT_TAG_NONE;
+
+	//a cache sequence stays in one lun
+	if((GenerateNandRowAddr(reqSlotTag) / LUN_1_BASE_ADDR) != (GenerateNandRowAddr(nextReqSlotTag) / LUN_1_BASE_ADDR))
+		return REQ_SLOT_TAG_NONE;
+
+	return nextReqSlotTag;
+}
+
+void CompleteNandCacheReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatus)
+{
+	unsigned int cacheReqSlotTag, rowAddr, phyBlockNo;
+
+	cacheReqSlotTag = dieStateTablePtr->dieState[chNo][wayNo].cacheReq;
+	if(cacheReqSlotTag == REQ_SLOT_TAG_NONE)
+		return;
+
+	if(reqPoolPtr->reqPool[cacheReqSlotTag].reqCode == REQ_CODE_WRITE)
+	{
+		//the cached page was programmed before the following page left the cache register, one status covers both
+		if(reqStatus == REQ_STATUS_FAIL)
+		{
+			rowAddr = GenerateNandRowAddr(cacheReqSlotTag);
+			phyBlockNo = ((rowAddr % LUN_1_BASE_ADDR) / PAGES_PER_MLC_BLOCK) + ((rowAddr / LUN_1_BASE_ADDR)* TOTAL_BLOCKS_PER_LUN);
+			UpdatePhyBlockMapForGrownBadBlock(Pcw2VdieTranslation(chNo, wayNo), phyBlockNo);
+		}
+
+		dieStateTablePtr->dieState[chNo][wayNo].cacheReq = REQ_SLOT_TAG_NONE;
+		PutToNandReqQHead(cacheReqSlotTag, chNo, wayNo);
+		GetFromNandReqQ(chNo, wayNo, reqStatus, REQ_CODE_WRITE);
+	}
+	else if(reqPoolPtr->reqPool[cacheReqSlotTag].reqCode == REQ_CODE_READ)
+	{
+		//the next page left the array during the transfer, it only needs its own transfer
+		reqPoolPtr->reqPool[cacheReqSlotTag].reqCode = REQ_CODE_READ_TRANSFER;
+	}
+}
+
 unsigned int GenerateNandRowAddr(unsigned int reqSlotTag)
 {
 	unsigned int rowAddr, lun, virtualBlockNo, tempBlockNo, phyBlockNo, tempPageNo, dieNo;
@@ -836,7 +1202,7 @@ unsigned int CheckReqStatus(unsigned int chNo, unsigned int wayNo)
 		if(V2FRequestReportDone(statusReport))
 		{
 			status = V2FEliminateReportDoneFlag(statusReport);
-			if(V2FRequestComplete(status))
+			if(V2FRequestComplete(status) || (dieStateTablePtr->dieState[chNo][wayNo].cacheOp && V2FRequestCacheReady(status)))
 			{
 				if (V2FRequestFail(status))
 					return REQ_STATUS_FAIL;
@@ -885,7 +1251,7 @@ unsigned int CheckEccErrorInfo(unsigned int chNo, unsigned int wayNo)
 
 void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatus)
 {
-	unsigned int reqSlotTag, rowAddr, phyBlockNo;
+	unsigned int reqSlotTag, rowAddr, phyBlockNo, fusedReqSlotTag, nextReqSlotTag;
 	unsigned char* badCheck ;
 
 	reqSlotTag = nandReqQ[chNo][wayNo].headReq;
@@ -896,29 +1262,76 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
 			IssueNandReq(chNo, wayNo);
 			dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_EXE;
 			break;
+		case DIE_STATE_SUSPEND:
+			if(reqStatus == REQ_STATUS_DONE)
+				dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_IDLE;
+			break;
 		case DIE_STATE_EXE:
 			if(reqStatus == REQ_STATUS_DONE)
 			{
+				fusedReqSlotTag = dieStateTablePtr->dieState[chNo][wayNo].fusedReq;
+				dieStateTablePtr->dieState[chNo][wayNo].fusedReq = REQ_SLOT_TAG_NONE;
+
 				if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ)
+				{
 					reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ_TRANSFER;
+
+					//the page of the other plane waits in its own page register, it only needs the transfer
+					if(fusedReqSlotTag != REQ_SLOT_TAG_NONE)
+						reqPoolPtr->reqPool[fusedReqSlotTag].reqCode = REQ_CODE_READ_TRANSFER;
+				}
 				else
 				{
 					retryLimitTablePtr->retryLimit[chNo][wayNo] = RETRY_LIMIT;
-					GetFromNandReqQ(chNo, wayNo, reqStatus, reqPoolPtr->reqPool[reqSlotTag].reqCode);
+					CompleteNandCacheReq(chNo, wayNo, reqStatus);
+
+					if(dieStateTablePtr->dieState[chNo][wayNo].cacheOp)
+					{
+						//the page is still being programmed, it completes with the status of the next program
+						dieStateTablePtr->dieState[chNo][wayNo].cacheOp = 0;
+						dieStateTablePtr->dieState[chNo][wayNo].cacheReq = reqSlotTag;
+						SelectiveGetFromNandReqQ(reqSlotTag, chNo, wayNo);
+					}
+					else
+					{
+						GetFromNandReqQ(chNo, wayNo, reqStatus, reqPoolPtr->reqPool[reqSlotTag].reqCode);
+
+						if(fusedReqSlotTag != REQ_SLOT_TAG_NONE)
+							GetFromNandReqQ(chNo, wayNo, reqStatus, reqPoolPtr->reqPool[fusedReqSlotTag].reqCode);
+					}
 				}
 
 				dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_IDLE;
 			}
 			else if(reqStatus == REQ_STATUS_FAIL)
 			{
+				fusedReqSlotTag = dieStateTablePtr->dieState[chNo][wayNo].fusedReq;
+				dieStateTablePtr->dieState[chNo][wayNo].fusedReq = REQ_SLOT_TAG_NONE;
+				dieStateTablePtr->dieState[chNo][wayNo].cacheOp = 0;
+
 				if((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ) || (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER))
 					if(retryLimitTablePtr->retryLimit[chNo][wayNo] > 0)
 					{
 						retryLimitTablePtr->retryLimit[chNo][wayNo]--;
 
+						//the retried trigger starts over, the page read ahead by the cache read is dropped and triggered again
+						if(dieStateTablePtr->dieState[chNo][wayNo].cacheReq != REQ_SLOT_TAG_NONE)
+						{
+							v2fExtOps.readCacheEndAsync(&chCtlReg[chNo], wayNo);
+							dieStateTablePtr->dieState[chNo][wayNo].cacheReq = REQ_SLOT_TAG_NONE;
+						}
+
 						if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER)
+						{
 							reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
 
+							//the retried trigger overwrites the page register, the other plane's page is read again with it
+							nextReqSlotTag = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+							if(nextReqSlotTag != REQ_SLOT_TAG_NONE)
+								if(reqPoolPtr->reqPool[nextReqSlotTag].reqCode == REQ_CODE_READ_TRANSFER)
+									reqPoolPtr->reqPool[nextReqSlotTag].reqCode = REQ_CODE_READ;
+						}
+
 						dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_IDLE;
 						return;
 					}
@@ -949,6 +1362,17 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
 
 				retryLimitTablePtr->retryLimit[chNo][wayNo] = RETRY_LIMIT;
 				GetFromNandReqQ(chNo, wayNo, reqStatus, reqPoolPtr->reqPool[reqSlotTag].reqCode);
+
+				//a multi-plane program reports one status, the block of the other plane is treated as failed as well
+				if((fusedReqSlotTag != REQ_SLOT_TAG_NONE) && (reqPoolPtr->reqPool[fusedReqSlotTag].reqCode == REQ_CODE_WRITE))
+				{
+					rowAddr = GenerateNandRowAddr(fusedReqSlotTag);
+					phyBlockNo = ((rowAddr % LUN_1_BASE_ADDR) / PAGES_PER_MLC_BLOCK) + ((rowAddr / LUN_1_BASE_ADDR)* TOTAL_BLOCKS_PER_LUN);
+					UpdatePhyBlockMapForGrownBadBlock(Pcw2VdieTranslation(chNo, wayNo), phyBlockNo);
+
+					GetFromNandReqQ(chNo, wayNo, reqStatus, reqPoolPtr->reqPool[fusedReqSlotTag].reqCode);
+				}
+				CompleteNandCacheReq(chNo, wayNo, reqStatus);
 				dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_IDLE;
 			}
 			else if(reqStatus == REQ_STATUS_WARNING)
@@ -962,6 +1386,7 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
 
 				retryLimitTablePtr->retryLimit[chNo][wayNo] = RETRY_LIMIT;
 				GetFromNandReqQ(chNo, wayNo, reqStatus, reqPoolPtr->reqPool[reqSlotTag].reqCode);
+				CompleteNandCacheReq(chNo, wayNo, reqStatus);
 				dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_IDLE;
 			}
 			else if(reqStatus == REQ_STATUS_RUNNING)
@@ -971,3 +1396,214 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
 			break;
 	}
 }
+
+unsigned int GetNandReqClass(unsigned int reqSlotTag)
+{
+	if((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ) || (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER))
+	{
+		//garbage collection copies read into the temporary buffer without a logical address, read-modify-write reads keep theirs
+		if((reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat == REQ_OPT_DATA_BUF_TEMP_ENTRY) && (reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr == LSA_NONE))
+			return REQ_CLASS_GC;
+
+		return REQ_CLASS_HOST_READ;
+	}
+	else if((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_WRITE) && (reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat == REQ_OPT_DATA_BUF_ENTRY))
+		return REQ_CLASS_HOST_WRITE;
+
+	return REQ_CLASS_GC;
+}
+
+unsigned int GetNandReqDeadline(unsigned int reqSlotTag)
+{
+	return reqPoolPtr->reqPool[reqSlotTag].issueTime + reqClassDeadlineTicks[GetNandReqClass(reqSlotTag)];
+}
+
+unsigned int SelectEarliestDeadlineWay(unsigned int chNo)
+{
+	unsigned int wayNo, earliestWay, deadline, earliestDeadline, listNo;
+	unsigned int listHead[4];
+
+	listHead[0] = wayPriorityTablePtr->wayPriority[chNo].readTriggerHead;
+	listHead[1] = wayPriorityTablePtr->wayPriority[chNo].readTransferHead;
+	listHead[2] = wayPriorityTablePtr->wayPriority[chNo].eraseHead;
+	listHead[3] = wayPriorityTablePtr->wayPriority[chNo].writeHead;
+
+	earliestWay = WAY_NONE;
+	earliestDeadline = 0;
+	for(listNo = 0; listNo < 4; listNo++)
+	{
+		wayNo = listHead[listNo];
+		while(wayNo != WAY_NONE)
+		{
+			deadline = GetNandReqDeadline(nandReqQ[chNo][wayNo].headReq);
+
+			//the timer word wraps, deadlines are compared by their signed distance
+			if((earliestWay == WAY_NONE) || ((int)(deadline - earliestDeadline) < 0))
+			{
+				earliestWay = wayNo;
+				earliestDeadline = deadline;
+			}
+
+			wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+		}
+	}
+
+	return earliestWay;
+}
+
+void SelectNandReqQHead(unsigned int chNo, unsigned int wayNo)
+{
+	unsigned int reqSlotTag, scanCnt;
+
+	reqSlotTag = nandReqQ[chNo][wayNo].headReq;
+	//a read transfer at the head is the other plane of a finished multi-plane trigger, its page register must be drained first
+	if((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ) || (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER))
+	{
+		dieStateTablePtr->dieState[chNo][wayNo].readBypassCnt = 0;
+		return ;
+	}
+	if(dieStateTablePtr->dieState[chNo][wayNo].suspendedReq != REQ_SLOT_TAG_NONE)
+		return ;
+	//the array still programs the cached page, nothing but the next program may enter the die
+	if(dieStateTablePtr->dieState[chNo][wayNo].cacheReq != REQ_SLOT_TAG_NONE)
+		return ;
+
+	//starvation cap, the waiting program or erase is issued now
+	if(dieStateTablePtr->dieState[chNo][wayNo].readBypassCnt >= NAND_READ_BYPASS_MAX)
+	{
+		dieStateTablePtr->dieState[chNo][wayNo].readBypassCnt = 0;
+		return ;
+	}
+
+	scanCnt = 0;
+	reqSlotTag = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+	while((reqSlotTag != REQ_SLOT_TAG_NONE) && (scanCnt < NAND_READ_BYPASS_SCAN_DEPTH))
+	{
+		if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ)
+			if(CheckNandReadBypass(reqSlotTag, chNo, wayNo))
+			{
+				SelectiveGetFromNandReqQ(reqSlotTag, chNo, wayNo);
+				PutToNandReqQHead(reqSlotTag, chNo, wayNo);
+				dieStateTablePtr->dieState[chNo][wayNo].readBypassCnt++;
+				return ;
+			}
+
+		reqSlotTag = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+		scanCnt++;
+	}
+
+	dieStateTablePtr->dieState[chNo][wayNo].readBypassCnt = 0;
+}
+
+unsigned int CheckNandReadBypass(unsigned int readReqSlotTag, unsigned int chNo, unsigned int wayNo)
+{
+	unsigned int reqSlotTag, blockNo;
+
+	//buffer dependencies are already resolved for requests in the way queue, only the blocks ahead can conflict
+	if(reqPoolPtr->reqPool[readReqSlotTag].reqOpt.nandAddr != REQ_OPT_NAND_ADDR_VSA)
+		return 0;
+
+	blockNo = Vsa2VblockTranslation(reqPoolPtr->reqPool[readReqSlotTag].nandInfo.virtualSliceAddr);
+
+	reqSlotTag = nandReqQ[chNo][wayNo].headReq;
+	while(reqSlotTag != readReqSlotTag)
+	{
+		if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr != REQ_OPT_NAND_ADDR_VSA)
+			return 0;
+		if((reqPoolPtr->reqPool[reqSlotTag].reqCode != REQ_CODE_READ) && (Vsa2VblockTranslation(reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr) == blockNo))
+			return 0;
+
+		reqSlotTag = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+	}
+
+	return 1;
+}
+
+unsigned int CheckNandSuspendBypass(unsigned int suspendedReqSlotTag, unsigned int reqSlotTag)
+{
+	if(reqSlotTag == REQ_SLOT_TAG_NONE)
+		return 0;
+	if(reqPoolPtr->reqPool[reqSlotTag].reqCode != REQ_CODE_READ)
+		return 0;
+	if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr != REQ_OPT_NAND_ADDR_VSA)
+		return 0;
+
+	//the suspended block is left alone, a read of it may target the page being programmed
+	if(Vsa2VblockTranslation(reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr) == Vsa2VblockTranslation(reqPoolPtr->reqPool[suspendedReqSlotTag].nandInfo.virtualSliceAddr))
+		return 0;
+
+	return 1;
+}
+
+unsigned int CheckNandSuspendRequired(unsigned int chNo, unsigned int wayNo)
+{
+	unsigned int reqSlotTag;
+
+	//nothing is suspended until the driver provides both routines
+	if(!v2fExtOps.suspendAsync || !v2fExtOps.resumeAsync)
+		return 0;
+	if(dieStateTablePtr->dieState[chNo][wayNo].dieState != DIE_STATE_EXE)
+		return 0;
+	if(dieStateTablePtr->dieState[chNo][wayNo].suspendCnt >= NAND_SUSPEND_CNT_MAX)
+		return 0;
+	if(dieStateTablePtr->dieState[chNo][wayNo].fusedReq != REQ_SLOT_TAG_NONE)
+		return 0;
+	if(dieStateTablePtr->dieState[chNo][wayNo].cacheOp || (dieStateTablePtr->dieState[chNo][wayNo].cacheReq != REQ_SLOT_TAG_NONE))
+		return 0;
+
+	reqSlotTag = nandReqQ[chNo][wayNo].headReq;
+	if((reqPoolPtr->reqPool[reqSlotTag].reqCode != REQ_CODE_WRITE) && (reqPoolPtr->reqPool[reqSlotTag].reqCode != REQ_CODE_ERASE))
+		return 0;
+	if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr != REQ_OPT_NAND_ADDR_VSA)
+		return 0;
+
+	return CheckNandSuspendBypass(reqSlotTag, reqPoolPtr->reqPool[reqSlotTag].nextReq);
+}
+
+void SuspendNandReq(unsigned int chNo, unsigned int wayNo)
+{
+	dieStateTablePtr->dieState[chNo][wayNo].suspendedReq = nandReqQ[chNo][wayNo].headReq;
+	SelectiveGetFromNandReqQ(nandReqQ[chNo][wayNo].headReq, chNo, wayNo);
+	dieStateTablePtr->dieState[chNo][wayNo].suspendReadCnt = 1;
+	dieStateTablePtr->dieState[chNo][wayNo].suspendCnt++;
+
+	v2fExtOps.suspendAsync(&chCtlReg[chNo], wayNo);
+
+	dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_SUSPEND;
+	dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_NONE;
+}
+
+void ResumeNandReq(unsigned int chNo, unsigned int wayNo)
+{
+	PutToNandReqQHead(dieStateTablePtr->dieState[chNo][wayNo].suspendedReq, chNo, wayNo);
+	dieStateTablePtr->dieState[chNo][wayNo].suspendedReq = REQ_SLOT_TAG_NONE;
+
+	v2fExtOps.resumeAsync(&chCtlReg[chNo], wayNo);
+
+	dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_EXE;
+	dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_CHECK;
+}
+
+unsigned int UpdateNandSuspend(unsigned int chNo, unsigned int wayNo)
+{
+	unsigned int suspendedReqSlotTag;
+
+	suspendedReqSlotTag = dieStateTablePtr->dieState[chNo][wayNo].suspendedReq;
+	if(suspendedReqSlotTag == REQ_SLOT_TAG_NONE)
+	{
+		//the completed request was not a bypassing read, so the next program or erase starts with no suspension
+		dieStateTablePtr->dieState[chNo][wayNo].suspendCnt = 0;
+		return NAND_SUSPEND_REPORT_KEEP;
+	}
+
+	if(dieStateTablePtr->dieState[chNo][wayNo].suspendReadCnt < NAND_SUSPEND_READ_MAX)
+		if(CheckNandSuspendBypass(suspendedReqSlotTag, nandReqQ[chNo][wayNo].headReq))
+		{
+			dieStateTablePtr->dieState[chNo][wayNo].suspendReadCnt++;
+			return NAND_SUSPEND_REPORT_KEEP;
+		}
+
+	ResumeNandReq(chNo, wayNo);
+
+	return NAND_SUSPEND_REPORT_RESUMED;
+}
@@ -61,6 +61,26 @@
 
 #define DIE_STATE_IDLE			0
 #define DIE_STATE_EXE			1
+#define DIE_STATE_SUSPEND		2		//suspend issued to the running program or erase, waiting for the die to become ready
+
+#define REQ_CLASS_HOST_READ		0
+#define REQ_CLASS_HOST_WRITE	1
+#define REQ_CLASS_GC			2		//garbage collection copies, erases and the other internal operations
+#define REQ_CLASS_COUNT			3
+
+//target latency of each request class, a request is due this long after it was taken from the free queue
+#define HOST_READ_TARGET_LATENCY_US		200
+#define HOST_WRITE_TARGET_LATENCY_US	2000
+#define GC_TARGET_LATENCY_US			10000
+
+#define NAND_READ_BYPASS_MAX			8		//reads overtaking one program or erase before it is issued
+#define NAND_READ_BYPASS_SCAN_DEPTH		8
+
+#define NAND_SUSPEND_READ_MAX	4		//reads served per suspension before the suspended operation is resumed
+#define NAND_SUSPEND_CNT_MAX	4		//suspensions of one program or erase, bounds its completion time
+
+#define NAND_SUSPEND_REPORT_KEEP		0
+#define NAND_SUSPEND_REPORT_RESUMED		1
 
 #define REQ_STATUS_CHECK_OPT_NONE 				0
 #define REQ_STATUS_CHECK_OPT_CHECK				1
@@ -98,7 +118,14 @@ typedef struct _DIE_STATE_ENTRY {
 	unsigned int reqStatusCheckOpt	:	4;
 	unsigned int prevWay	:	4;
 	unsigned int nextWay 	:	4;
-	unsigned int reserved	:	12;
+	unsigned int readBypassCnt	:	8;
+	unsigned int cacheOp	:	1;		//the running program releases the die at cache ready
+	unsigned int reserved	:	3;
+	unsigned int suspendedReq	:	16;		//program or erase detached from the NAND request queue while reads go ahead of it
+	unsigned int suspendReadCnt	:	8;
+	unsigned int suspendCnt	:	8;
+	unsigned int fusedReq	:	16;		//request issued with the queue head as the other plane of a multi-plane operation
+	unsigned int cacheReq	:	16;		//request whose array operation overlaps the transfer of the queue head
 } DIE_STATE_ENTRY, *P_DIE_STATE_ENTRY;
 
 typedef struct _DIE_STATE_TABLE {
@@ -134,8 +161,12 @@ void InitReqScheduler();
 void SyncAllLowLevelReqDone();
 void SyncAvailFreeReq();
 void SyncReleaseEraseReq(unsigned int chNo, unsigned int wayNo, unsigned int blockNo);
+void SyncReleaseGcCopy();
 void SchedulingNandReq();
 void SchedulingNandReqPerCh(unsigned int chNo);
+unsigned int CheckNandChEvent(unsigned int chNo);
+void SetNandWayActive(unsigned int chNo, unsigned int wayNo);
+void ClearNandWayActive(unsigned int chNo, unsigned int wayNo);
 
 void PutToNandWayPriorityTable(unsigned int reqSlotTag, unsigned int chNo, unsigned int wayNo);
 void PutToNandIdleList(unsigned int chNo, unsigned int wayNo);
@@ -154,6 +185,9 @@ void PutToNandStatusCheckList(unsigned int chNo, unsigned int wayNo);
 void SelectiveGetFromNandStatusCheckList(unsigned int chNo, unsigned int wayNo);
 
 void IssueNandReq(unsigned int chNo, unsigned int wayNo);
+unsigned int SelectNandPlaneFusedReq(unsigned int chNo, unsigned int wayNo);
+unsigned int SelectNandCacheReq(unsigned int chNo, unsigned int wayNo);
+void CompleteNandCacheReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatus);
 unsigned int GenerateNandRowAddr(unsigned int reqSlotTag);
 unsigned int GenerateDataBufAddr(unsigned int reqSlotTag);
 unsigned int GenerateSpareDataBufAddr(unsigned int reqSlotTag);
@@ -162,6 +196,19 @@ unsigned int CheckEccErrorInfo(unsigned int chNo, unsigned int wayNo);
 
 void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatus);
 
+unsigned int GetNandReqClass(unsigned int reqSlotTag);
+unsigned int GetNandReqDeadline(unsigned int reqSlotTag);
+unsigned int SelectEarliestDeadlineWay(unsigned int chNo);
+
+void SelectNandReqQHead(unsigned int chNo, unsigned int wayNo);
+unsigned int CheckNandReadBypass(unsigned int readReqSlotTag, unsigned int chNo, unsigned int wayNo);
+
+unsigned int CheckNandSuspendBypass(unsigned int suspendedReqSlotTag, unsigned int reqSlotTag);
+unsigned int CheckNandSuspendRequired(unsigned int chNo, unsigned int wayNo);
+void SuspendNandReq(unsigned int chNo, unsigned int wayNo);
+void ResumeNandReq(unsigned int chNo, unsigned int wayNo);
+unsigned int UpdateNandSuspend(unsigned int chNo, unsigned int wayNo);
+
 
 extern P_COMPLETE_FLAG_TABLE completeFlagTablePtr;
 extern P_STATUS_REPORT_TABLE statusReportTablePtr;
@@ -169,6 +216,10 @@ extern P_ERROR_INFO_TABLE eccErrorInfoTablePtr;
 extern P_RETRY_LIMIT_TABLE retryLimitTablePtr;
 extern P_DIE_STATE_TABLE dieStatusTablePtr;
 extern P_WAY_PRIORITY_TABLE wayPriorityTablePtr;
+extern unsigned int reqClassDeadlineTicks[REQ_CLASS_COUNT];
+extern unsigned int nandChEventMask;
+extern unsigned int nandChActiveMask;
+extern unsigned int nandWayActiveMask[USER_CHANNELS];
 
 
 #endif /* REQUEST_SCHEDULE_H_ */
@@ -49,12 +49,15 @@
 
 #include "xil_printf.h"
 #include <assert.h>
+#include <string.h>
 #include "nvme/nvme.h"
 #include "nvme/host_lld.h"
 #include "memory_map.h"
 #include "ftl_config.h"
 
 P_ROW_ADDR_DEPENDENCY_TABLE rowAddrDependencyTablePtr;
+READ_AHEAD_STREAM_TABLE readAheadStreamTable;
+unsigned int fastPathTxTail, fastPathTxOverFlowCnt;
 
 void InitDependencyTable()
 {
@@ -75,9 +78,9 @@ void InitDependencyTable()
 	}
 }
 
-void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigned int nlb, unsigned int cmdCode)
+void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int qID, unsigned int startLba, unsigned int nlb, unsigned int cmdCode)
 {
-	unsigned int reqSlotTag, requestedNvmeBlock, tempNumOfNvmeBlock, transCounter, tempLsa, loop, nvmeBlockOffset, nvmeDmaStartIndex, reqCode;
+	unsigned int reqSlotTag, requestedNvmeBlock, tempNumOfNvmeBlock, transCounter, tempLsa, loop, nvmeBlockOffset, nvmeDmaStartIndex, reqCode, tenantNo;
 
 	requestedNvmeBlock = nlb + 1;
 	transCounter = 0;
@@ -92,6 +95,16 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
 	else
 		assert(!"[WARNING] Not supported command code [WARNING]");
 
+	//IO submission queues start from 1
+	tenantNo = (qID - 1) % DATA_BUF_TENANT_COUNT;
+
+//the fast path issues host DMA, which only the host interface core may do
+#if (READ_HIT_FAST_PATH && !DUAL_CORE_FTL)
+	if(reqCode == REQ_CODE_READ)
+		if(ServeReadHitFastPath(cmdSlotTag, startLba, nlb, tenantNo) == FAST_PATH_REPORT_DONE)
+			return ;
+#endif
+
 	//first transform
 	nvmeBlockOffset = (startLba % NVME_BLOCKS_PER_SLICE);
 	if(loop)
@@ -108,6 +121,7 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
 	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.startIndex = nvmeDmaStartIndex;
 	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset = nvmeBlockOffset;
 	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock = tempNumOfNvmeBlock;
+	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.tenantNo = tenantNo;
 
 	PutToSliceReqQ(reqSlotTag);
 
@@ -130,6 +144,7 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
 		reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.startIndex = nvmeDmaStartIndex;
 		reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset = nvmeBlockOffset;
 		reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock = tempNumOfNvmeBlock;
+		reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.tenantNo = tenantNo;
 
 		PutToSliceReqQ(reqSlotTag);
 
@@ -153,40 +168,231 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
 	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.startIndex = nvmeDmaStartIndex;
 	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset = nvmeBlockOffset;
 	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock = tempNumOfNvmeBlock;
+	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.tenantNo = tenantNo;
 
 	PutToSliceReqQ(reqSlotTag);
 }
 
 
 
+unsigned int ServeReadHitFastPath(unsigned int cmdSlotTag, unsigned int startLba, unsigned int nlb, unsigned int tenantNo)
+{
+	unsigned int logicalSliceAddr, startLsa, endLsa, endLba, sliceStartLba, sliceEndLba, bufEntry, sectorMask, lba, dmaIndex;
+
+	//slice requests queued earlier may still write the requested slices
+	if(sliceReqQ.headReq != REQ_SLOT_TAG_NONE)
+		return FAST_PATH_REPORT_FAIL;
+
+	endLba = startLba + nlb;
+	startLsa = startLba / NVME_BLOCKS_PER_SLICE;
+	endLsa = endLba / NVME_BLOCKS_PER_SLICE;
+
+	//every slice has to hit an entry which holds the requested sectors and has no request pending on it
+	for(logicalSliceAddr = startLsa; logicalSliceAddr <= endLsa; logicalSliceAddr++)
+	{
+		bufEntry = LookupDataBuf(logicalSliceAddr);
+		if(bufEntry == DATA_BUF_FAIL)
+			return FAST_PATH_REPORT_FAIL;
+		if(dataBufMapPtr->dataBuf[bufEntry].blockingReqTail != REQ_SLOT_TAG_NONE)
+			return FAST_PATH_REPORT_FAIL;
+
+		sliceStartLba = (logicalSliceAddr == startLsa) ? startLba : logicalSliceAddr * NVME_BLOCKS_PER_SLICE;
+		sliceEndLba = (logicalSliceAddr == endLsa) ? endLba : logicalSliceAddr * NVME_BLOCKS_PER_SLICE + NVME_BLOCKS_PER_SLICE - 1;
+		sectorMask = NvmeBlockRange2SectorMaskTranslation(sliceStartLba % NVME_BLOCKS_PER_SLICE, sliceEndLba - sliceStartLba + 1);
+		if((dataBufMapPtr->dataBuf[bufEntry].sectorValidMask & sectorMask) != sectorMask)
+			return FAST_PATH_REPORT_FAIL;
+	}
+
+	dmaIndex = 0;
+	for(logicalSliceAddr = startLsa; logicalSliceAddr <= endLsa; logicalSliceAddr++)
+	{
+		bufEntry = LookupDataBuf(logicalSliceAddr);
+
+		sliceStartLba = (logicalSliceAddr == startLsa) ? startLba : logicalSliceAddr * NVME_BLOCKS_PER_SLICE;
+		sliceEndLba = (logicalSliceAddr == endLsa) ? endLba : logicalSliceAddr * NVME_BLOCKS_PER_SLICE + NVME_BLOCKS_PER_SLICE - 1;
+		for(lba = sliceStartLba; lba <= sliceEndLba; lba++)
+		{
+			set_auto_tx_dma(cmdSlotTag, dmaIndex, DATA_BUFFER_BASE_ADDR + bufEntry * BYTES_PER_DATA_REGION_OF_SLICE + (lba % NVME_BLOCKS_PER_SLICE) * BYTES_PER_NVME_BLOCK,
+					NVME_COMMAND_AUTO_COMPLETION_ON);
+			dmaIndex++;
+		}
+
+		TouchDataBuf(bufEntry);
+		dataBufMapPtr->dataBuf[bufEntry].fastPathTx = 1;
+	}
+
+	//host DMA is processed in order, so the tail of the latest fast path covers every fast path entry
+	fastPathTxTail = g_hostDmaStatus.fifoTail.autoDmaTx;
+	fastPathTxOverFlowCnt = g_hostDmaAssistStatus.autoDmaTxOverFlowCnt;
+
+#if (READ_AHEAD)
+	for(logicalSliceAddr = startLsa; logicalSliceAddr <= endLsa; logicalSliceAddr++)
+		UpdateReadAheadStream(logicalSliceAddr, 1, tenantNo);
+#endif
+
+	return FAST_PATH_REPORT_DONE;
+}
+
+void SyncReleaseFastPathTxDma(unsigned int dataBufEntry)
+{
+	if(dataBufMapPtr->dataBuf[dataBufEntry].fastPathTx)
+	{
+		while(!check_auto_tx_dma_partial_done(fastPathTxTail, fastPathTxOverFlowCnt))
+			;
+
+		dataBufMapPtr->dataBuf[dataBufEntry].fastPathTx = 0;
+	}
+}
+
 void EvictDataBufEntry(unsigned int originReqSlotTag)
 {
-	unsigned int reqSlotTag, virtualSliceAddr, dataBufEntry;
+	unsigned int dataBufEntry;
 
 	dataBufEntry = reqPoolPtr->reqPool[originReqSlotTag].dataBufInfo.entry;
 	if(dataBufMapPtr->dataBuf[dataBufEntry].dirty == DATA_BUF_DIRTY)
+		WriteBackDataBufEntry(dataBufEntry);
+}
+
+void WriteBackDataBufEntry(unsigned int dataBufEntry)
+{
+	unsigned int reqSlotTag, virtualSliceAddr;
+
+	reqSlotTag = GetFromFreeReqQ();
+
+	//read-modify-write deferred from the partial host writes, the old slice is read before its mapping is replaced
+	if(dataBufMapPtr->dataBuf[dataBufEntry].sectorValidMask != SECTOR_MASK_FULL)
+		FillDataBufEntry(dataBufEntry, reqSlotTag);
+
+	virtualSliceAddr =  AddrTransWrite(dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr);
+
+	reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+	reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_WRITE;
+	reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ENTRY;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_ON;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
+	reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = dataBufEntry;
+	UpdateDataBufEntryInfoBlockingReq(dataBufEntry, reqSlotTag);
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
+
+	SelectLowLevelReqQ(reqSlotTag);
+
+	dataBufMapPtr->dataBuf[dataBufEntry].dirty = DATA_BUF_CLEAN;
+	dirtyDataBufCnt--;
+}
+
+void FillDataBufEntry(unsigned int dataBufEntry, unsigned int waitingReqSlotTag)
+{
+	unsigned int reqSlotTag, virtualSliceAddr, logicalSliceAddr, tempDataBufEntry;
+
+	logicalSliceAddr = dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr;
+
+	if(CheckRmwReadRequired(logicalSliceAddr, dataBufMapPtr->dataBuf[dataBufEntry].sectorValidMask) == RMW_READ_NOT_REQUIRED)
 	{
-		reqSlotTag = GetFromFreeReqQ();
-		virtualSliceAddr =  AddrTransWrite(dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr);
+		dataBufMapPtr->dataBuf[dataBufEntry].sectorValidMask = SECTOR_MASK_FULL;
+		return ;
+	}
 
-		reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
-		reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_WRITE;
-		reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag = reqPoolPtr->reqPool[originReqSlotTag].nvmeCmdSlotTag;
-		reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr;
-		reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ENTRY;
-		reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
-		reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
-		reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_ON;
-		reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
-		reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
-		reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = dataBufEntry;
-		UpdateDataBufEntryInfoBlockingReq(dataBufEntry, reqSlotTag);
-		reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
+	virtualSliceAddr = AddrTransRead(logicalSliceAddr);
+	if(virtualSliceAddr == VSA_FAIL)
+	{
+		dataBufMapPtr->dataBuf[dataBufEntry].sectorValidMask = SECTOR_MASK_FULL;
+		return ;
+	}
 
-		SelectLowLevelReqQ(reqSlotTag);
+	//the old slice is read into the temporary buffer so that the sectors written by host are preserved
+	tempDataBufEntry = AllocateTempDataBuf(Vsa2VdieTranslation(virtualSliceAddr));
+	reqSlotTag = GetFromFreeReqQ();
+
+	reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+	reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
+	reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_ON;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFill = REQ_OPT_DATA_BUF_FILL_READ;
+	reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = tempDataBufEntry;
+	UpdateTempDataBufEntryInfoBlockingReq(tempDataBufEntry, reqSlotTag);
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
+	reqPoolPtr->reqPool[reqSlotTag].dataBufFillInfo.dataBufEntry = dataBufEntry;
+	reqPoolPtr->reqPool[reqSlotTag].dataBufFillInfo.waitingReq = waitingReqSlotTag;
+	reqPoolPtr->reqPool[reqSlotTag].dataBufFillInfo.heldSectorMask = dataBufMapPtr->dataBuf[dataBufEntry].sectorValidMask;
+
+	//the request which needs the whole slice is not issued until MergeDataBufEntry has run
+	reqPoolPtr->reqPool[waitingReqSlotTag].reqOpt.dataBufFill = REQ_OPT_DATA_BUF_FILL_WAIT;
+
+	SelectLowLevelReqQ(reqSlotTag);
+
+	//every later user of the entry is queued behind the waiting request, so the entry counts as full from now on
+	dataBufMapPtr->dataBuf[dataBufEntry].sectorValidMask = SECTOR_MASK_FULL;
+}
 
-		dataBufMapPtr->dataBuf[dataBufEntry].dirty = DATA_BUF_CLEAN;
+void MergeDataBufEntry(unsigned int reqSlotTag)
+{
+	unsigned int waitingReqSlotTag, dataBufEntry, tempDataBufEntry, heldSectorMask, sectorNo;
+
+	waitingReqSlotTag = reqPoolPtr->reqPool[reqSlotTag].dataBufFillInfo.waitingReq;
+	heldSectorMask = reqPoolPtr->reqPool[reqSlotTag].dataBufFillInfo.heldSectorMask;
+	dataBufEntry = reqPoolPtr->reqPool[reqSlotTag].dataBufFillInfo.dataBufEntry;
+	tempDataBufEntry = reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry;
+
+	//requests queued on the entry before the fill touch only the held sectors, so they need not be waited for
+	for(sectorNo = 0; sectorNo < NVME_BLOCKS_PER_SLICE; sectorNo++)
+		if(!(heldSectorMask & (1 << sectorNo)))
+			memcpy((void*)(DATA_BUFFER_BASE_ADDR + dataBufEntry * BYTES_PER_DATA_REGION_OF_SLICE + sectorNo * BYTES_PER_NVME_BLOCK),
+					(void*)(TEMPORARY_DATA_BUFFER_BASE_ADDR + tempDataBufEntry * BYTES_PER_DATA_REGION_OF_SLICE + sectorNo * BYTES_PER_NVME_BLOCK), BYTES_PER_NVME_BLOCK);
+
+	reqPoolPtr->reqPool[waitingReqSlotTag].reqOpt.dataBufFill = REQ_OPT_DATA_BUF_FILL_NONE;
+
+	//the waiting request may not be queued yet, SelectLowLevelReqQ issues it then
+	if((reqPoolPtr->reqPool[waitingReqSlotTag].reqQueueType == REQ_QUEUE_TYPE_BLOCKED_BY_BUF_DEP) && (CheckBufDep(waitingReqSlotTag) == BUF_DEPENDENCY_REPORT_PASS))
+		IssueBlockedByBufDepReq(waitingReqSlotTag);
+}
+
+void WriteBackDataBuf()
+{
+	static unsigned int writeBackActive = 0;
+	unsigned int bufEntry, lruList, scanCnt, batchCnt, batchNo;
+	unsigned int batch[WRITE_BACK_BATCH_SIZE];
+
+	if(dirtyDataBufCnt > DIRTY_DATA_BUF_HIGH_WATERMARK)
+		writeBackActive = 1;
+	else if(dirtyDataBufCnt <= DIRTY_DATA_BUF_LOW_WATERMARK)
+		writeBackActive = 0;
+
+	if(!writeBackActive)
+		return ;
+	if(freeReqQ.reqCnt < freeReqQ.reservedReqCnt + WRITE_BACK_FREE_REQ_MARGIN + WRITE_BACK_BATCH_SIZE)
+		return ;
+
+	//collect dirty entries in eviction order, probation tail first and then protected tail
+	batchCnt = 0;
+	scanCnt = 0;
+	for(lruList = DATA_BUF_LIST_PROBATION; lruList < DATA_BUF_LIST_COUNT; lruList++)
+	{
+		bufEntry = dataBufLruList[lruList].tailEntry;
+		while((bufEntry != DATA_BUF_NONE) && (scanCnt < WRITE_BACK_SCAN_DEPTH) && (batchCnt < WRITE_BACK_BATCH_SIZE))
+		{
+			if(dataBufMapPtr->dataBuf[bufEntry].dirty == DATA_BUF_DIRTY)
+				batch[batchCnt++] = bufEntry;
+
+			bufEntry = dataBufMapPtr->dataBuf[bufEntry].prevEntry;
+			scanCnt++;
+		}
 	}
+
+	//issue only full batches, so that consecutive allocations place one program on every die
+	if(batchCnt < WRITE_BACK_BATCH_SIZE)
+		return ;
+
+	for(batchNo = 0; batchNo < batchCnt; batchNo++)
+		WriteBackDataBufEntry(batch[batchNo]);
 }
 
 void DataReadFromNand(unsigned int originReqSlotTag)
@@ -202,6 +408,7 @@ void DataReadFromNand(unsigned int originReqSlotTag)
 		reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
 		reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
 		reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag = reqPoolPtr->reqPool[originReqSlotTag].nvmeCmdSlotTag;
+		reqPoolPtr->reqPool[reqSlotTag].issueTime = reqPoolPtr->reqPool[originReqSlotTag].issueTime;
 		reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = reqPoolPtr->reqPool[originReqSlotTag].logicalSliceAddr;
 		reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ENTRY;
 		reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
@@ -219,9 +426,248 @@ void DataReadFromNand(unsigned int originReqSlotTag)
 }
 
 
+void InitReadAhead()
+{
+	unsigned int streamNo;
+
+	for(streamNo = 0; streamNo < READ_AHEAD_STREAM_COUNT; streamNo++)
+	{
+		readAheadStreamTable.stream[streamNo].nextLsa = LSA_NONE;
+		readAheadStreamTable.stream[streamNo].prefetchedLsa = LSA_NONE;
+		readAheadStreamTable.stream[streamNo].lastAccess = 0;
+		readAheadStreamTable.stream[streamNo].window = 0;
+		readAheadStreamTable.stream[streamNo].valid = 0;
+	}
+
+	readAheadStreamTable.accessClock = 0;
+}
+
+void UpdateReadAheadStream(unsigned int logicalSliceAddr, unsigned int bufHit, unsigned int tenantNo)
+{
+	unsigned int streamNo, victimStreamNo, lsa, endLsa;
+	P_READ_AHEAD_STREAM_ENTRY stream;
+
+	readAheadStreamTable.accessClock++;
+
+	for(streamNo = 0; streamNo < READ_AHEAD_STREAM_COUNT; streamNo++)
+		if(readAheadStreamTable.stream[streamNo].valid && (readAheadStreamTable.stream[streamNo].nextLsa == logicalSliceAddr))
+			break;
+
+	if(streamNo == READ_AHEAD_STREAM_COUNT)
+	{
+		//not a continuation of a tracked stream, start tracking it in place of the least recently used stream
+		victimStreamNo = 0;
+		for(streamNo = 0; streamNo < READ_AHEAD_STREAM_COUNT; streamNo++)
+		{
+			if(!readAheadStreamTable.stream[streamNo].valid)
+			{
+				victimStreamNo = streamNo;
+				break;
+			}
+			if(readAheadStreamTable.stream[streamNo].lastAccess < readAheadStreamTable.stream[victimStreamNo].lastAccess)
+				victimStreamNo = streamNo;
+		}
+
+		stream = &readAheadStreamTable.stream[victimStreamNo];
+		stream->nextLsa = logicalSliceAddr + 1;
+		stream->prefetchedLsa = logicalSliceAddr + 1;
+		stream->lastAccess = readAheadStreamTable.accessClock;
+		stream->window = READ_AHEAD_WINDOW_MIN;
+		stream->valid = 1;
+
+		return ;
+	}
+
+	stream = &readAheadStreamTable.stream[streamNo];
+
+	if(logicalSliceAddr < stream->prefetchedLsa)
+	{
+		//the host reached read-ahead data, widen the window while it hits and narrow it when it was evicted unused
+		if(bufHit)
+		{
+			if(stream->window < READ_AHEAD_WINDOW_MAX)
+				stream->window = (stream->window * 2 < READ_AHEAD_WINDOW_MAX) ? stream->window * 2 : READ_AHEAD_WINDOW_MAX;
+		}
+		else
+			stream->window = stream->window / 2;
+	}
+	else if((stream->window != 0) && (stream->window < READ_AHEAD_WINDOW_MAX))
+	{
+		//the host outran read-ahead
+		stream->window = (stream->window * 2 < READ_AHEAD_WINDOW_MAX) ? stream->window * 2 : READ_AHEAD_WINDOW_MAX;
+	}
+
+	stream->nextLsa = logicalSliceAddr + 1;
+	stream->lastAccess = readAheadStreamTable.accessClock;
+
+	lsa = (stream->prefetchedLsa > stream->nextLsa) ? stream->prefetchedLsa : stream->nextLsa;
+	endLsa = stream->nextLsa + stream->window;
+	if(endLsa > SLICES_PER_SSD)
+		endLsa = SLICES_PER_SSD;
+
+	while(lsa < endLsa)
+	{
+		if(PrefetchDataBuf(lsa, tenantNo) == PREFETCH_REPORT_FAIL)
+			break;
+		lsa++;
+	}
+
+	if(lsa > stream->prefetchedLsa)
+		stream->prefetchedLsa = lsa;
+}
+
+unsigned int PrefetchDataBuf(unsigned int logicalSliceAddr, unsigned int tenantNo)
+{
+	unsigned int reqSlotTag, virtualSliceAddr, dataBufEntry;
+
+	if(freeReqQ.reqCnt < freeReqQ.reservedReqCnt + READ_AHEAD_FREE_REQ_MARGIN)
+		return PREFETCH_REPORT_FAIL;
+
+	if(LookupDataBuf(logicalSliceAddr) != DATA_BUF_FAIL)
+		return PREFETCH_REPORT_DONE;
+
+	virtualSliceAddr = AddrTransRead(logicalSliceAddr);
+	if(virtualSliceAddr == VSA_FAIL)
+		return PREFETCH_REPORT_DONE;
+
+	dataBufEntry = AllocateCleanDataBuf(tenantNo);
+	if(dataBufEntry == DATA_BUF_FAIL)
+		return PREFETCH_REPORT_FAIL;
+
+	dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr = logicalSliceAddr;
+	dataBufMapPtr->dataBuf[dataBufEntry].prefetched = 1;
+	dataBufMapPtr->dataBuf[dataBufEntry].sectorValidMask = SECTOR_MASK_FULL;
+	PutToDataBufHashList(dataBufEntry);
+
+	reqSlotTag = GetUnreservedFromFreeReqQ();
+
+	reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+	reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
+	reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ENTRY;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_ON;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
+
+	reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = dataBufEntry;
+	UpdateDataBufEntryInfoBlockingReq(dataBufEntry, reqSlotTag);
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
+
+	SelectLowLevelReqQ(reqSlotTag);
+
+	return PREFETCH_REPORT_DONE;
+}
+
+unsigned int PinDataBufRange(unsigned int startLsa, unsigned int sliceCnt)
+{
+	unsigned int lsa, dataBufEntry, newPinCnt;
+
+	newPinCnt = 0;
+	for(lsa = startLsa; lsa < startLsa + sliceCnt; lsa++)
+	{
+		dataBufEntry = LookupDataBuf(lsa);
+		if((dataBufEntry == DATA_BUF_FAIL) || !dataBufMapPtr->dataBuf[dataBufEntry].pinned)
+			newPinCnt++;
+	}
+
+	//the whole range is rejected rather than pinned in part
+	if(pinnedDataBufCnt + newPinCnt > DATA_BUF_PIN_ENTRY_COUNT_MAX)
+		return PIN_REPORT_FAIL;
+
+	for(lsa = startLsa; lsa < startLsa + sliceCnt; lsa++)
+		PinDataBufEntry(lsa);
+
+	return PIN_REPORT_DONE;
+}
+
+unsigned int UnpinDataBufRange(unsigned int startLsa, unsigned int sliceCnt)
+{
+	unsigned int lsa, dataBufEntry;
+
+	for(lsa = startLsa; lsa < startLsa + sliceCnt; lsa++)
+	{
+		dataBufEntry = LookupDataBuf(lsa);
+		if((dataBufEntry != DATA_BUF_FAIL) && dataBufMapPtr->dataBuf[dataBufEntry].pinned)
+		{
+			dataBufMapPtr->dataBuf[dataBufEntry].pinned = 0;
+			PutToDataBufLruList(dataBufEntry, DATA_BUF_LIST_PROBATION);
+			pinnedDataBufCnt--;
+		}
+	}
+
+	return PIN_REPORT_DONE;
+}
+
+void PinDataBufEntry(unsigned int logicalSliceAddr)
+{
+	unsigned int reqSlotTag, virtualSliceAddr, dataBufEntry;
+
+	dataBufEntry = LookupDataBuf(logicalSliceAddr);
+	if(dataBufEntry == DATA_BUF_FAIL)
+	{
+		dataBufEntry = AllocateDataBuf(DATA_BUF_TENANT_NONE);
+		if(dataBufMapPtr->dataBuf[dataBufEntry].dirty == DATA_BUF_DIRTY)
+			WriteBackDataBufEntry(dataBufEntry);
+
+		dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr = logicalSliceAddr;
+		dataBufMapPtr->dataBuf[dataBufEntry].sectorValidMask = SECTOR_MASK_FULL;
+		PutToDataBufHashList(dataBufEntry);
+
+		virtualSliceAddr = AddrTransRead(logicalSliceAddr);
+		if(virtualSliceAddr != VSA_FAIL)
+		{
+			reqSlotTag = GetFromFreeReqQ();
+
+			reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+			reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
+			reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
+			reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ENTRY;
+			reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
+			reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
+			reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_ON;
+			reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK;
+			reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
+
+			reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = dataBufEntry;
+			UpdateDataBufEntryInfoBlockingReq(dataBufEntry, reqSlotTag);
+			reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = virtualSliceAddr;
+
+			SelectLowLevelReqQ(reqSlotTag);
+		}
+	}
+	else if(dataBufMapPtr->dataBuf[dataBufEntry].pinned)
+		return ;
+
+	//host requests keep finding the entry through the hash list, only the eviction path loses sight of it
+	SelectiveGetFromDataBufLruList(dataBufEntry);
+	dataBufMapPtr->dataBuf[dataBufEntry].prefetched = 0;
+	dataBufMapPtr->dataBuf[dataBufEntry].pinned = 1;
+	pinnedDataBufCnt++;
+}
+
+void FlushPinnedDataBuf()
+{
+	unsigned int bufEntry;
+
+	if(pinnedDataBufCnt == 0)
+		return ;
+
+	for(bufEntry = 0; bufEntry < dataBufEntryCnt; bufEntry++)
+		if(dataBufMapPtr->dataBuf[bufEntry].pinned && (dataBufMapPtr->dataBuf[bufEntry].dirty == DATA_BUF_DIRTY))
+			WriteBackDataBufEntry(bufEntry);
+
+	SyncAllLowLevelReqDone();
+}
+
+
 void ReqTransSliceToLowLevel()
 {
-	unsigned int reqSlotTag, dataBufEntry;
+	unsigned int reqSlotTag, dataBufEntry, sectorMask;
+#if (READ_AHEAD)
+	unsigned int bufHit;
+#endif
 
 	while(sliceReqQ.headReq != REQ_SLOT_TAG_NONE)
 	{
@@ -234,12 +680,19 @@ void ReqTransSliceToLowLevel()
 		if(dataBufEntry != DATA_BUF_FAIL)
 		{
 			//data buffer hit
+#if (READ_AHEAD)
+			bufHit = 1;
+#endif
 			reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = dataBufEntry;
 		}
 		else
 		{
+#if (READ_AHEAD)
+			bufHit = 0;
+#endif
+
 			//data buffer miss, allocate a new buffer entry
-			dataBufEntry = AllocateDataBuf();
+			dataBufEntry = AllocateDataBuf(reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.tenantNo);
 			reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = dataBufEntry;
 
 			//clear the allocated data buffer entry being used by a previous request
@@ -249,21 +702,38 @@ void ReqTransSliceToLowLevel()
 			dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr = reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr;
 			PutToDataBufHashList(dataBufEntry);
 
+			//a write miss defers the read-modify-write until the entry is programmed, it may be fully written by then
 			if(reqPoolPtr->reqPool[reqSlotTag].reqCode  == REQ_CODE_READ)
+			{
 				DataReadFromNand(reqSlotTag);
-			else if(reqPoolPtr->reqPool[reqSlotTag].reqCode  == REQ_CODE_WRITE)
-				if(reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock != NVME_BLOCKS_PER_SLICE) //for read modify write
-					DataReadFromNand(reqSlotTag);
+				dataBufMapPtr->dataBuf[dataBufEntry].sectorValidMask = SECTOR_MASK_FULL;
+			}
+			else
+				dataBufMapPtr->dataBuf[dataBufEntry].sectorValidMask = SECTOR_MASK_NONE;
 		}
 
+		sectorMask = NvmeBlockRange2SectorMaskTranslation(reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset,
+				reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock);
+
 		//transform this slice request to nvme request
 		if(reqPoolPtr->reqPool[reqSlotTag].reqCode  == REQ_CODE_WRITE)
 		{
+			SyncReleaseFastPathTxDma(dataBufEntry);
+			UpdateValidSector(reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr, reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset,
+					reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock);
+			dataBufMapPtr->dataBuf[dataBufEntry].sectorValidMask |= sectorMask;
+			if(dataBufMapPtr->dataBuf[dataBufEntry].dirty == DATA_BUF_CLEAN)
+				dirtyDataBufCnt++;
 			dataBufMapPtr->dataBuf[dataBufEntry].dirty = DATA_BUF_DIRTY;
 			reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_RxDMA;
 		}
 		else if(reqPoolPtr->reqPool[reqSlotTag].reqCode  == REQ_CODE_READ)
+		{
+			//a hit on a partially written entry is served directly only if the requested sectors are held, otherwise the transfer waits for the fill
+			if((dataBufMapPtr->dataBuf[dataBufEntry].sectorValidMask & sectorMask) != sectorMask)
+				FillDataBufEntry(dataBufEntry, reqSlotTag);
 			reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_TxDMA;
+		}
 		else
 			assert(!"[WARNING] Not supported reqCode. [WARNING]");
 
@@ -272,12 +742,44 @@ void ReqTransSliceToLowLevel()
 
 		UpdateDataBufEntryInfoBlockingReq(dataBufEntry, reqSlotTag);
 		SelectLowLevelReqQ(reqSlotTag);
+
+#if (READ_AHEAD)
+		//prefetch after the demand request so that it is queued ahead of the read-ahead reads
+		if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_TxDMA)
+			UpdateReadAheadStream(reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr, bufHit, reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.tenantNo);
+#endif
 	}
 }
 
+//runs on the core running the FTL, the counters read here are updated by that core only except the atomic free slot count
+unsigned int AdmitNvmeIoCmd(unsigned int sliceCnt)
+{
+	unsigned int usedReqCnt;
+
+	if(sliceCnt == 0)
+		return ADMISSION_REPORT_DONE;
+
+	//every entry with a request pending on it holds a slot, the rest can be evicted for the new slices
+	usedReqCnt = AVAILABLE_OUNTSTANDING_REQ_COUNT - freeReqQ.reqCnt;
+	if(sliceCnt + freeReqQ.reservedReqCnt + usedReqCnt + pinnedDataBufCnt > dataBufEntryCnt)
+		return ADMISSION_REPORT_FAIL;
+
+	if(!ReserveFreeReq(sliceCnt * NVME_IO_CMD_REQ_PER_SLICE))
+		return ADMISSION_REPORT_FAIL;
+
+	return ADMISSION_REPORT_DONE;
+}
+
+//the command is admitted, transformed and released in one pass, so at most one reservation is held at a time
+void ReleaseNvmeIoCmdAdmission(unsigned int sliceCnt)
+{
+	if(sliceCnt)
+		UnreserveFreeReq();
+}
+
 unsigned int CheckBufDep(unsigned int reqSlotTag)
 {
-	if(reqPoolPtr->reqPool[reqSlotTag].prevBlockingReq == REQ_SLOT_TAG_NONE)
+	if((reqPoolPtr->reqPool[reqSlotTag].prevBlockingReq == REQ_SLOT_TAG_NONE) && (reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFill != REQ_OPT_DATA_BUF_FILL_WAIT))
 		return BUF_DEPENDENCY_REPORT_PASS;
 	else
 		return BUF_DEPENDENCY_REPORT_BLOCKED;
@@ -412,8 +914,13 @@ void SelectLowLevelReqQ(unsigned int reqSlotTag)
 	{
 		if(reqPoolPtr->reqPool[reqSlotTag].reqType  == REQ_TYPE_NVME_DMA)
 		{
+#if (DUAL_CORE_FTL)
+			PutToNvmeDmaReqQ(reqSlotTag);
+			PutToCoreSlotRing(&coreRingMapPtr->dmaIssueRing, reqSlotTag);
+#else
 			IssueNvmeDmaReq(reqSlotTag);
 			PutToNvmeDmaReqQ(reqSlotTag);
+#endif
 		}
 		else if(reqPoolPtr->reqPool[reqSlotTag].reqType  == REQ_TYPE_NAND)
 		{
@@ -477,7 +984,16 @@ void SelectLowLevelReqQ(unsigned int reqSlotTag)
 
 void ReleaseBlockedByBufDepReq(unsigned int reqSlotTag)
 {
-	unsigned int targetReqSlotTag, dieNo, chNo, wayNo, rowAddrDepCheckReport;
+	unsigned int targetReqSlotTag;
+
+	//the temporary entry must not be handed to the next request before the old slice is merged out of it
+	if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFill == REQ_OPT_DATA_BUF_FILL_READ)
+		MergeDataBufEntry(reqSlotTag);
+#if (REVERSE_MAP_IN_SPARE)
+	//the copy write must carry the lsa before it is released
+	else if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFill == REQ_OPT_DATA_BUF_FILL_GC_COPY)
+		CompleteGcCopyRead(reqSlotTag);
+#endif
 
 	targetReqSlotTag = REQ_SLOT_TAG_NONE;
 	if(reqPoolPtr->reqPool[reqSlotTag].nextBlockingReq != REQ_SLOT_TAG_NONE)
@@ -498,42 +1014,54 @@ void ReleaseBlockedByBufDepReq(unsigned int reqSlotTag)
 			tempDataBufMapPtr->tempDataBuf[reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry].blockingReqTail = REQ_SLOT_TAG_NONE;
 	}
 
+	//a request still waiting for the fill of its entry is issued by MergeDataBufEntry
 	if((targetReqSlotTag != REQ_SLOT_TAG_NONE) && (reqPoolPtr->reqPool[targetReqSlotTag].reqQueueType == REQ_QUEUE_TYPE_BLOCKED_BY_BUF_DEP))
-	{
-		SelectiveGetFromBlockedByBufDepReqQ(targetReqSlotTag);
+		if(CheckBufDep(targetReqSlotTag) == BUF_DEPENDENCY_REPORT_PASS)
+			IssueBlockedByBufDepReq(targetReqSlotTag);
+}
 
-		if(reqPoolPtr->reqPool[targetReqSlotTag].reqType == REQ_TYPE_NVME_DMA)
+void IssueBlockedByBufDepReq(unsigned int reqSlotTag)
+{
+	unsigned int dieNo, chNo, wayNo, rowAddrDepCheckReport;
+
+	SelectiveGetFromBlockedByBufDepReqQ(reqSlotTag);
+
+	if(reqPoolPtr->reqPool[reqSlotTag].reqType == REQ_TYPE_NVME_DMA)
+	{
+#if (DUAL_CORE_FTL)
+		PutToNvmeDmaReqQ(reqSlotTag);
+		PutToCoreSlotRing(&coreRingMapPtr->dmaIssueRing, reqSlotTag);
+#else
+		IssueNvmeDmaReq(reqSlotTag);
+		PutToNvmeDmaReqQ(reqSlotTag);
+#endif
+	}
+	else if(reqPoolPtr->reqPool[reqSlotTag].reqType  == REQ_TYPE_NAND)
+	{
+		if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr == REQ_OPT_NAND_ADDR_VSA)
 		{
-			IssueNvmeDmaReq(targetReqSlotTag);
-			PutToNvmeDmaReqQ(targetReqSlotTag);
+			dieNo = Vsa2VdieTranslation(reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr);
+			chNo =  Vdie2PchTranslation(dieNo);
+			wayNo = Vdie2PwayTranslation(dieNo);
 		}
-		else if(reqPoolPtr->reqPool[targetReqSlotTag].reqType  == REQ_TYPE_NAND)
-		{
-			if(reqPoolPtr->reqPool[targetReqSlotTag].reqOpt.nandAddr == REQ_OPT_NAND_ADDR_VSA)
-			{
-				dieNo = Vsa2VdieTranslation(reqPoolPtr->reqPool[targetReqSlotTag].nandInfo.virtualSliceAddr);
-				chNo =  Vdie2PchTranslation(dieNo);
-				wayNo = Vdie2PwayTranslation(dieNo);
-			}
-			else
-				assert(!"[WARNING] Not supported reqOpt-nandAddress [WARNING]");
+		else
+			assert(!"[WARNING] Not supported reqOpt-nandAddress [WARNING]");
 
-			if(reqPoolPtr->reqPool[targetReqSlotTag].reqOpt.rowAddrDependencyCheck == REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK)
-			{
-				rowAddrDepCheckReport = CheckRowAddrDep(targetReqSlotTag, ROW_ADDR_DEPENDENCY_CHECK_OPT_RELEASE);
+		if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck == REQ_OPT_ROW_ADDR_DEPENDENCY_CHECK)
+		{
+			rowAddrDepCheckReport = CheckRowAddrDep(reqSlotTag, ROW_ADDR_DEPENDENCY_CHECK_OPT_RELEASE);
 
-				if(rowAddrDepCheckReport == ROW_ADDR_DEPENDENCY_REPORT_PASS)
-					PutToNandReqQ(targetReqSlotTag, chNo, wayNo);
-				else if(rowAddrDepCheckReport == ROW_ADDR_DEPENDENCY_REPORT_BLOCKED)
-					PutToBlockedByRowAddrDepReqQ(targetReqSlotTag, chNo, wayNo);
-				else
-					assert(!"[WARNING] Not supported report [WARNING]");
-			}
-			else if(reqPoolPtr->reqPool[targetReqSlotTag].reqOpt.rowAddrDependencyCheck == REQ_OPT_ROW_ADDR_DEPENDENCY_NONE)
-				PutToNandReqQ(targetReqSlotTag, chNo, wayNo);
+			if(rowAddrDepCheckReport == ROW_ADDR_DEPENDENCY_REPORT_PASS)
+				PutToNandReqQ(reqSlotTag, chNo, wayNo);
+			else if(rowAddrDepCheckReport == ROW_ADDR_DEPENDENCY_REPORT_BLOCKED)
+				PutToBlockedByRowAddrDepReqQ(reqSlotTag, chNo, wayNo);
 			else
-				assert(!"[WARNING] Not supported reqOpt [WARNING]");
+				assert(!"[WARNING] Not supported report [WARNING]");
 		}
+		else if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck == REQ_OPT_ROW_ADDR_DEPENDENCY_NONE)
+			PutToNandReqQ(reqSlotTag, chNo, wayNo);
+		else
+			assert(!"[WARNING] Not supported reqOpt [WARNING]");
 	}
 }
 
@@ -612,6 +1140,13 @@ void IssueNvmeDmaReq(unsigned int reqSlotTag)
 
 void CheckDoneNvmeDmaReq()
 {
+#if (DUAL_CORE_FTL)
+	unsigned int reqSlotTag;
+
+	//the host interface core checks the DMA progress and passes back the finished requests
+	while((reqSlotTag = GetFromCoreSlotRing(&coreRingMapPtr->dmaDoneRing)) != REQ_SLOT_TAG_NONE)
+		SelectiveGetFromNvmeDmaReqQ(reqSlotTag);
+#else
 	unsigned int reqSlotTag, prevReq;
 	unsigned int rxDone, txDone;
 
@@ -642,7 +1177,43 @@ void CheckDoneNvmeDmaReq()
 
 		reqSlotTag = prevReq;
 	}
+#endif
 }
 
+void ServiceNvmeDmaReq()
+{
+	unsigned int reqSlotTag, cmdSlotTag;
+
+	while((reqSlotTag = GetFromCoreSlotRing(&coreRingMapPtr->dmaIssueRing)) != REQ_SLOT_TAG_NONE)
+	{
+		IssueNvmeDmaReq(reqSlotTag);
+
+		if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_RxDMA)
+			PutToCoreSlotRing(&coreRingMapPtr->rxDmaRing, reqSlotTag);
+		else
+			PutToCoreSlotRing(&coreRingMapPtr->txDmaRing, reqSlotTag);
+	}
 
+	//host DMA of each direction is processed in order, so only the oldest request has to be checked
+	while((reqSlotTag = PeekCoreSlotRing(&coreRingMapPtr->rxDmaRing)) != REQ_SLOT_TAG_NONE)
+	{
+		if(!check_auto_rx_dma_partial_done(reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.reqTail , reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.overFlowCnt))
+			break;
 
+		GetFromCoreSlotRing(&coreRingMapPtr->rxDmaRing);
+		PutToCoreSlotRing(&coreRingMapPtr->dmaDoneRing, reqSlotTag);
+	}
+
+	while((reqSlotTag = PeekCoreSlotRing(&coreRingMapPtr->txDmaRing)) != REQ_SLOT_TAG_NONE)
+	{
+		if(!check_auto_tx_dma_partial_done(reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.reqTail , reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.overFlowCnt))
+			break;
+
+		GetFromCoreSlotRing(&coreRingMapPtr->txDmaRing);
+		PutToCoreSlotRing(&coreRingMapPtr->dmaDoneRing, reqSlotTag);
+	}
+
+	//commands finished without data transfer, such as flush
+	while((cmdSlotTag = GetFromCoreSlotRing(&coreRingMapPtr->cplRing)) != REQ_SLOT_TAG_NONE)
+		set_auto_nvme_cpl(cmdSlotTag, 0, 0);
+}
@@ -64,6 +64,28 @@
 #define ROW_ADDR_DEPENDENCY_TABLE_UPDATE_REPORT_DONE	0
 #define ROW_ADDR_DEPENDENCY_TABLE_UPDATE_REPORT_SYNC	1
 
+#define READ_AHEAD_STREAM_COUNT		8
+#define READ_AHEAD_WINDOW_MIN		(USER_DIES)		//one slice per die, sequentially written slices are striped over dies
+#define READ_AHEAD_WINDOW_MAX		(USER_DIES * 4)
+#define READ_AHEAD_FREE_REQ_MARGIN	(USER_DIES * 8)	//keep request slots for host requests
+
+#define PREFETCH_REPORT_DONE		0
+#define PREFETCH_REPORT_FAIL		1
+
+#define WRITE_BACK_FREE_REQ_MARGIN	(USER_DIES * 8)
+
+#define FAST_PATH_REPORT_DONE		0
+#define FAST_PATH_REPORT_FAIL		1
+
+#define PIN_REPORT_DONE				0
+#define PIN_REPORT_FAIL				1
+
+//a slice may take its own request, an eviction write, the read-modify-write read of the evicted entry and a NAND read
+#define NVME_IO_CMD_REQ_PER_SLICE	4
+
+#define ADMISSION_REPORT_DONE		0
+#define ADMISSION_REPORT_FAIL		1
+
 
 typedef struct _ROW_ADDR_DEPENDENCY_ENTRY {
 	unsigned int permittedProgPage : 12;
@@ -76,16 +98,49 @@ typedef struct _ROW_ADDR_DEPENDENCY_TABLE {
 	ROW_ADDR_DEPENDENCY_ENTRY block[USER_CHANNELS][USER_WAYS][MAIN_BLOCKS_PER_DIE];
 } ROW_ADDR_DEPENDENCY_TABLE, *P_ROW_ADDR_DEPENDENCY_TABLE;
 
+typedef struct _READ_AHEAD_STREAM_ENTRY {
+	unsigned int nextLsa;			//slice expected next if the stream stays sequential
+	unsigned int prefetchedLsa;		//first slice after the prefetched window
+	unsigned int lastAccess;
+	unsigned int window : 16;		//prefetch depth in slices, 0 once read-ahead data stops being hit
+	unsigned int valid : 1;
+	unsigned int reserved0 : 15;
+} READ_AHEAD_STREAM_ENTRY, *P_READ_AHEAD_STREAM_ENTRY;
+
+typedef struct _READ_AHEAD_STREAM_TABLE {
+	READ_AHEAD_STREAM_ENTRY stream[READ_AHEAD_STREAM_COUNT];
+	unsigned int accessClock;
+} READ_AHEAD_STREAM_TABLE, *P_READ_AHEAD_STREAM_TABLE;
+
 void InitDependencyTable();
-void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigned int nlb, unsigned int cmdCode);
+void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int qID, unsigned int startLba, unsigned int nlb, unsigned int cmdCode);
 void ReqTransSliceToLowLevel();
+unsigned int AdmitNvmeIoCmd(unsigned int sliceCnt);
+void ReleaseNvmeIoCmdAdmission(unsigned int sliceCnt);
+void WriteBackDataBufEntry(unsigned int dataBufEntry);
+void FillDataBufEntry(unsigned int dataBufEntry, unsigned int waitingReqSlotTag);
+void MergeDataBufEntry(unsigned int reqSlotTag);
+void WriteBackDataBuf();
+unsigned int ServeReadHitFastPath(unsigned int cmdSlotTag, unsigned int startLba, unsigned int nlb, unsigned int tenantNo);
+void SyncReleaseFastPathTxDma(unsigned int dataBufEntry);
+void InitReadAhead();
+void UpdateReadAheadStream(unsigned int logicalSliceAddr, unsigned int bufHit, unsigned int tenantNo);
+unsigned int PrefetchDataBuf(unsigned int logicalSliceAddr, unsigned int tenantNo);
+unsigned int PinDataBufRange(unsigned int startLsa, unsigned int sliceCnt);
+unsigned int UnpinDataBufRange(unsigned int startLsa, unsigned int sliceCnt);
+void PinDataBufEntry(unsigned int logicalSliceAddr);
+void FlushPinnedDataBuf();
 void IssueNvmeDmaReq(unsigned int reqSlotTag);
 void CheckDoneNvmeDmaReq();
+void ServiceNvmeDmaReq();
 
+unsigned int CheckBufDep(unsigned int reqSlotTag);
 void SelectLowLevelReqQ(unsigned int reqSlotTag);
 void ReleaseBlockedByBufDepReq(unsigned int reqSlotTag);
+void IssueBlockedByBufDepReq(unsigned int reqSlotTag);
 void ReleaseBlockedByRowAddrDepReq(unsigned int chNo, unsigned int wayNo);
 
 extern P_ROW_ADDR_DEPENDENCY_TABLE rowAddrDependencyTablePtr;
+extern READ_AHEAD_STREAM_TABLE readAheadStreamTable;
 
 #endif /* REQUEST_TRANSFORM_H_ */